@@ -6,14 +6,35 @@ namespace eng
 {
 	struct CameraData
 	{
-		glm::mat4 viewMatrix;
-		glm::mat4 projectionMatrix;
-		glm::vec3 position;
+		glm::mat4 viewMatrix = glm::mat4(1.0f);
+		glm::mat4 projectionMatrix = glm::mat4(1.0f);
+		glm::vec3 position = glm::vec3(0.0f);
+		float nearPlane = 0.1f;
+		float farPlane = 1000.0f;
+		// Pixels, 0 when unknown. Used to estimate how large textures appear on screen.
+		float viewportHeight = 0.0f;
+	};
+
+	enum class LightType
+	{
+		// Shines towards the origin from its position, affects everything
+		Directional,
+		// Falls off to zero at its radius
+		Point
 	};
 
 	struct LightData
 	{
-		glm::vec3 color;
-		glm::vec3 position;
+		LightType type = LightType::Directional;
+		glm::vec3 color = glm::vec3(1.0f);
+		glm::vec3 position = glm::vec3(0.0f);
+		float radius = 10.0f;
+	};
+
+	// Axis aligned box in the local space of whatever owns it
+	struct BoundingBox
+	{
+		glm::vec3 min = glm::vec3(0.0f);
+		glm::vec3 max = glm::vec3(0.0f);
 	};
 }
\ No newline at end of file
@@ -3,6 +3,9 @@
 #include "scene/GameObject.h"
 #include "scene/Component.h"
 #include "scene/components/CameraComponent.h"
+#include "graphics/OpenGLGraphicsAPI.h"
+#include "graphics/NullGraphicsAPI.h"
+#include "profiling/Profiler.h"
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
@@ -53,7 +56,7 @@ namespace eng
 		return instance;
 	}
 
-	bool Engine::Init(int width, int height)
+	bool Engine::Init(int width, int height, bool headless)
 	{
 		if (!m_application)
 		{
@@ -63,6 +66,21 @@ namespace eng
 		Scene::RegisterTypes();
 		m_application->RegisterTypes();
 
+		m_headless = headless;
+		m_width = width;
+		m_height = height;
+
+		m_jobSystem.Init();
+
+		if (m_headless)
+		{
+			m_graphicsAPI = std::make_unique<NullGraphicsAPI>();
+			m_graphicsAPI->Init();
+			m_physicsManager.Init();
+			m_audioManager.Init(false);
+			return m_application->Init();
+		}
+
 #if defined (__linux__)
 		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_X11);
 #endif
@@ -94,7 +112,10 @@ namespace eng
 		glfwMakeContextCurrent(m_window);
 		gladLoadGL();
 
-		m_graphicsAPI.Init();
+		auto openGL = std::make_unique<OpenGLGraphicsAPI>();
+		openGL->SetProgramCacheFolder(m_fileSystem.GetExecutableFolder() / "shadercache");
+		m_graphicsAPI = std::move(openGL);
+		m_graphicsAPI->Init();
 		m_physicsManager.Init();
 		m_audioManager.Init();
 		return m_application->Init();
@@ -108,10 +129,17 @@ namespace eng
 		}
 
 		m_lastTimePoint = std::chrono::steady_clock::now();
-		while (!glfwWindowShouldClose(m_window) && !m_application->NeedsToBeClosed())
+		while ((m_headless || !glfwWindowShouldClose(m_window)) && !m_application->NeedsToBeClosed())
 		{
+			Profiler::GetInstance().BeginFrame();
+			PROFILE_SCOPE("Engine::Frame");
+
 			// processing inputs
-			glfwPollEvents();
+			if (!m_headless)
+			{
+				PROFILE_SCOPE("Engine::PollEvents");
+				glfwPollEvents();
+			}
 
 			// updating application logic
 			auto now = std::chrono::steady_clock::now();
@@ -120,18 +148,31 @@ namespace eng
 
 			m_physicsManager.Update(deltaTime);
 
-			m_application->Update(deltaTime);
+			{
+				PROFILE_SCOPE("Application::Update");
+				m_application->Update(deltaTime);
+			}
 
-			m_graphicsAPI.SetClearColor(0.8f, 0.8f, 0.8f, 1.0f); // Sky color
-			m_graphicsAPI.ClearBuffers();
+			// Textures decoded in the background go up a few per frame
+			m_textureManager.Update();
+
+			m_graphicsAPI->ResetStats();
+			m_graphicsAPI->BeginGpuFrame();
+			m_graphicsAPI->SetClearColor(0.8f, 0.8f, 0.8f, 1.0f); // Sky color
+			m_graphicsAPI->ClearBuffers();
 
 			CameraData cameraData;
-			std::vector<LightData> lights;
+			static const std::vector<LightData> noLights;
+			const std::vector<LightData>* lights = &noLights;
 
-			int width = 0;
-			int height = 0;
-			glfwGetWindowSize(m_window, &width, &height);
+			int width = m_width;
+			int height = m_height;
+			if (!m_headless)
+			{
+				glfwGetWindowSize(m_window, &width, &height);
+			}
 			float aspect = static_cast<float>(width) / static_cast<float>(height);
+			cameraData.viewportHeight = static_cast<float>(height);
 
 			if (m_currentScene)
 			{
@@ -144,16 +185,26 @@ namespace eng
 						cameraData.viewMatrix = cameraComponent->GetViewMatrix();
 						cameraData.projectionMatrix = cameraComponent->GetProjectionMatrix(aspect);
 						cameraData.position = cameraObject->GetWorldPosition();
+						cameraData.nearPlane = cameraComponent->GetNearPlane();
+						cameraData.farPlane = cameraComponent->GetFarPlane();
 					}
 				}
 
-				lights = m_currentScene->CollectLights();
+				lights = &m_currentScene->CollectLights();
 			}
 
-			m_renderQueue.Draw(m_graphicsAPI, cameraData, lights);
+			{
+				PROFILE_SCOPE("GraphicsAPI::UpdateFrameUniforms");
+				m_graphicsAPI->UpdateFrameUniforms(cameraData, *lights);
+			}
+			m_renderQueue.Draw(*m_graphicsAPI, cameraData);
 
 			// rendering
-			glfwSwapBuffers(m_window);
+			if (!m_headless)
+			{
+				PROFILE_SCOPE("Engine::SwapBuffers");
+				glfwSwapBuffers(m_window);
+			}
 
 			m_inputManager.SetMousePositionChanged(false);
 		}
@@ -161,15 +212,27 @@ namespace eng
 
 	void Engine::Destroy()
 	{
+		// Flushes a capture that is still running
+		Profiler::GetInstance().StopCapture();
+
 		if (m_application)
 		{
 			m_application->Destroy();
 			m_application.reset();
-			glfwTerminate();
+			m_jobSystem.Shutdown();
+			if (!m_headless)
+			{
+				glfwTerminate();
+			}
 			m_window = nullptr;
 		}
 	}
 
+	bool Engine::IsHeadless() const
+	{
+		return m_headless;
+	}
+
 	void Engine::SetApplication(Application* app)
 	{
 		m_application.reset(app);
@@ -187,7 +250,7 @@ namespace eng
 
 	GraphicsAPI& Engine::GetGraphicsAPI()
 	{
-		return m_graphicsAPI;
+		return *m_graphicsAPI;
 	}
 
 	RenderQueue& Engine::GetRenderQueue()
@@ -205,6 +268,11 @@ namespace eng
 		return m_textureManager;
 	}
 
+	MaterialManager& Engine::GetMaterialManager()
+	{
+		return m_materialManager;
+	}
+
 	PhysicsManager& Engine::GetPhysicsManager()
 	{
 		return m_physicsManager;
@@ -215,6 +283,11 @@ namespace eng
 		return m_audioManager;
 	}
 
+	JobSystem& Engine::GetJobSystem()
+	{
+		return m_jobSystem;
+	}
+
 	void Engine::SetScene(Scene* scene)
 	{
 		m_currentScene.reset(scene);
@@ -3,10 +3,12 @@
 #include "graphics/GraphicsAPI.h"
 #include "graphics/Texture.h"
 #include "render/RenderQueue.h"
+#include "render/Material.h"
 #include "scene/Scene.h"
 #include "io/FileSystem.h"
 #include "physics/PhysicsManager.h"
 #include "audio/AudioManager.h"
+#include "jobs/JobSystem.h"
 #include <memory>
 #include <chrono>
 
@@ -27,10 +29,13 @@ namespace eng
 		Engine& operator = (Engine&&) = delete;
 
 	public:
-		bool Init(int width, int height);
+		// Headless runs without a window and GL context, rendering goes to the null graphics backend
+		bool Init(int width, int height, bool headless = false);
 		void Run();
 		void Destroy();
 
+		bool IsHeadless() const;
+
 		void SetApplication(Application* app);
 		Application* GetApplication();
 		InputManager& GetInputManager();
@@ -38,8 +43,10 @@ namespace eng
 		RenderQueue& GetRenderQueue();
 		FileSystem& GetFileSystem();
 		TextureManager& GetTextureManager();
+		MaterialManager& GetMaterialManager();
 		PhysicsManager& GetPhysicsManager();
 		AudioManager& GetAudioManager();
+		JobSystem& GetJobSystem();
 
 		void SetScene(Scene* scene);
 		Scene* GetScene();
@@ -48,11 +55,16 @@ namespace eng
 		std::unique_ptr<Application> m_application;
 		std::chrono::steady_clock::time_point m_lastTimePoint;
 		GLFWwindow* m_window = nullptr;
+		bool m_headless = false;
+		int m_width = 0;
+		int m_height = 0;
+		JobSystem m_jobSystem;
 		InputManager m_inputManager;
-		GraphicsAPI m_graphicsAPI;
+		std::unique_ptr<GraphicsAPI> m_graphicsAPI;
 		RenderQueue m_renderQueue;
 		FileSystem m_fileSystem;
 		TextureManager m_textureManager;
+		MaterialManager m_materialManager;
 		PhysicsManager m_physicsManager;
 		AudioManager m_audioManager;
 		std::unique_ptr<Scene> m_currentScene;
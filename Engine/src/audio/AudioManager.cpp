@@ -17,9 +17,17 @@ namespace eng
 		}
 	}
 
-	bool AudioManager::Init()
+	bool AudioManager::Init(bool useDevice)
 	{
-		auto result = ma_engine_init(nullptr, m_engine.get());
+		ma_engine_config config = ma_engine_config_init();
+		if (!useDevice)
+		{
+			config.noDevice = MA_TRUE;
+			config.channels = 2;
+			config.sampleRate = 48000;
+		}
+
+		auto result = ma_engine_init(&config, m_engine.get());
 		return result == MA_SUCCESS;
 	}
 
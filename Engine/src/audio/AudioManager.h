@@ -12,7 +12,8 @@ namespace eng
 		AudioManager();
 		~AudioManager();
 
-		bool Init();
+		// Without a device sounds are mixed but never played, e.g. for headless runs
+		bool Init(bool useDevice = true);
 		ma_engine* GetEngine();
 
 		void SetListenerPosition(const glm::vec3& pos);
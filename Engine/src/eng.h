@@ -11,6 +11,7 @@
 #include "render/RenderQueue.h"
 #include "scene/GameObject.h"
 #include "scene/Scene.h"
+#include "scene/Prefab.h"
 #include "scene/Component.h"
 #include "scene/components/MeshComponent.h"
 #include "scene/components/CameraComponent.h"
@@ -27,4 +28,6 @@
 #include "physics/KinematicCharacterController.h"
 #include "physics/CollisionObject.h"
 #include "audio/AudioManager.h"
-#include "audio/Audio.h"
\ No newline at end of file
+#include "audio/Audio.h"
+#include "profiling/Profiler.h"
+#include "jobs/JobSystem.h"
\ No newline at end of file
@@ -2,64 +2,68 @@
 #include "ShaderProgram.h"
 #include "render/Material.h"
 #include "render/Mesh.h"
-#include <iostream>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstddef>
 
 namespace eng
 {
-	bool GraphicsAPI::Init()
+	std::shared_ptr<ShaderProgram> GraphicsAPI::CreateInstancedShaderProgram(const std::string& vertexSource, const std::string& fragmentSource)
 	{
-		glEnable(GL_DEPTH_TEST);
-		return true;
+		auto shaderProgram = CreateShaderProgram(vertexSource, fragmentSource);
+		if (shaderProgram)
+		{
+			shaderProgram->SetInstancedVariant(CreateShaderProgram(vertexSource, fragmentSource, { "INSTANCED" }));
+		}
+		return shaderProgram;
 	}
 
-	static unsigned int CompileShader(unsigned int type, const std::string& source)
+	std::shared_ptr<ShaderProgram> GraphicsAPI::GetOrCreateShaderProgram(const std::string& vertexSource, const std::string& fragmentSource, bool instanced)
 	{
-		unsigned int id = glCreateShader(type);
-		const char* src = source.c_str();
-		glShaderSource(id, 1, &src, nullptr);
-		glCompileShader(id);
+		// A program with an instanced variant is keyed apart from the plain one
+		const uint64_t key = instanced ?
+			HashShaderSources(vertexSource, fragmentSource, { "INSTANCED_VARIANT" }) :
+			HashShaderSources(vertexSource, fragmentSource);
+		auto it = m_shaderPrograms.find(key);
+		if (it != m_shaderPrograms.end())
+		{
+			if (auto shaderProgram = it->second.lock())
+			{
+				return shaderProgram;
+			}
+		}
 
-		// Error Handling
-		int result;
-		glGetShaderiv(id, GL_COMPILE_STATUS, &result);
-		if (!result)
+		auto shaderProgram = instanced ?
+			CreateInstancedShaderProgram(vertexSource, fragmentSource) :
+			CreateShaderProgram(vertexSource, fragmentSource);
+		if (shaderProgram)
 		{
-			// error message
-			char message[512];
-			glGetShaderInfoLog(id, 512, nullptr, message);
-			std::cerr << "Failed to compile " << (type == GL_VERTEX_SHADER ? "Vertex" : "Fragment") << " Shader!" << std::endl;
-			std::cerr << message << std::endl;
+			m_shaderPrograms[key] = shaderProgram;
 		}
-		return id;
+		return shaderProgram;
 	}
 
-	std::shared_ptr<ShaderProgram> GraphicsAPI::CreateShaderProgram(const std::string& vertexSource, const std::string& fragmentSource)
+	uint64_t GraphicsAPI::HashShaderSources(const std::string& vertexSource, const std::string& fragmentSource,
+		const std::vector<std::string>& defines)
 	{
-		unsigned int shaderProgramID = glCreateProgram();
-		unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexSource);
-		unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
-
-		glAttachShader(shaderProgramID, vs);
-		glAttachShader(shaderProgramID, fs);
-		glLinkProgram(shaderProgramID);
-		glValidateProgram(shaderProgramID);
+		uint64_t hash = 14695981039346656037ull;
+		auto add = [&hash](const std::string& text)
+			{
+				for (unsigned char c : text)
+				{
+					hash = (hash ^ c) * 1099511628211ull;
+				}
+				// Separator, so moving text from one part to the next changes the hash
+				hash = (hash ^ 0xffu) * 1099511628211ull;
+			};
 
-		// Error Handling
-		int result;
-		glGetShaderiv(shaderProgramID, GL_LINK_STATUS, &result);
-		if (!result)
+		add(vertexSource);
+		add(fragmentSource);
+		for (const auto& define : defines)
 		{
-			// error message
-			char message[512];
-			glGetShaderInfoLog(shaderProgramID, 512, nullptr, message);
-			std::cerr << "Failed to link Shaders!" << message << std::endl;
-			return nullptr;
+			add(define);
 		}
-
-		glDeleteShader(vs);
-		glDeleteShader(fs);
-
-		return std::make_shared<ShaderProgram>(shaderProgramID);
+		return hash;
 	}
 
 	const std::shared_ptr<ShaderProgram>& GraphicsAPI::GetDefaultShaderProgram()
@@ -73,24 +77,48 @@ namespace eng
 			layout(location = 1) in vec3 color;
 			layout(location = 2) in vec2 uv;
 			layout(location = 3) in vec3 normal;
+			#ifdef INSTANCED
+			layout(location = 4) in mat4 instanceModel;
+			#endif
+
+			struct Light
+			{
+				vec3 color;
+				vec3 direction;
+			};
+
+			layout(std140) uniform FrameData
+			{
+				mat4 uView;
+				mat4 uProjection;
+				vec3 uCameraPos;
+				int uLightCount;
+				uvec4 uClusterSize;
+				vec4 uClusterDepth;
+				Light uLights[MAX_LIGHTS];
+			};
 
 			out vec2 vUV;
 			out vec3 vNormal;
 			out vec3 vFragPos;
 
 			uniform mat4 uModel;
-			uniform mat4 uView;
-			uniform mat4 uProjection;
 
 			void main()
 			{
+				#ifdef INSTANCED
+				mat4 model = instanceModel;
+				#else
+				mat4 model = uModel;
+				#endif
+
 				vUV = uv;
 
-				vFragPos = vec3(uModel * vec4(position, 1.0));
+				vFragPos = vec3(model * vec4(position, 1.0));
 
-				vNormal = mat3(transpose(inverse(uModel))) * normal;
+				vNormal = mat3(transpose(inverse(model))) * normal;
 
-				gl_Position = uProjection * uView * uModel * vec4(position, 1.0);
+				gl_Position = uProjection * uView * model * vec4(position, 1.0);
 			}
 			)";
 
@@ -103,8 +131,16 @@ namespace eng
 				vec3 direction;
 			};
 
-			uniform Light uLight;
-			uniform vec3 uCameraPos;
+			layout(std140) uniform FrameData
+			{
+				mat4 uView;
+				mat4 uProjection;
+				vec3 uCameraPos;
+				int uLightCount;
+				uvec4 uClusterSize;
+				vec4 uClusterDepth;
+				Light uLights[MAX_LIGHTS];
+			};
 
 			out vec4 FragColor;
 
@@ -113,29 +149,76 @@ namespace eng
 			in vec3 vFragPos;
 
 			uniform sampler2D baseColorTexture;
+			uniform usamplerBuffer uClusterGrid;
+			uniform usamplerBuffer uClusterLightIndices;
+			uniform samplerBuffer uPointLights;
 
-			void main()
+			vec3 ShadeLight(vec3 lightDir, vec3 lightColor, vec3 norm, vec3 viewDir)
 			{
-				vec3 norm = normalize(vNormal);
-
-				
 				// diffuse
-				vec3 lightDir = normalize(-uLight.direction);
 				float diff = max(dot(norm, lightDir), 0.0);
-				vec3 diffuse = diff * uLight.color;
+				vec3 diffuse = diff * lightColor;
 
 				// specular
-				vec3 viewDir = normalize(uCameraPos - vFragPos);
-				vec3 redlectDir = reflect(-lightDir, norm);
-				float spec = pow(max(dot(viewDir, redlectDir), 0.0), 32.0);
+				vec3 reflectDir = reflect(-lightDir, norm);
+				float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0);
 				float specularStrength = 0.5;
-				vec3 specular = specularStrength * spec * uLight.color;
-				
+				vec3 specular = specularStrength * spec * lightColor;
+
+				return diffuse + specular;
+			}
+
+			int GetClusterIndex(vec3 fragPos)
+			{
+				vec4 viewPos = uView * vec4(fragPos, 1.0);
+				vec4 clipPos = uProjection * viewPos;
+				vec2 cell = (clipPos.xy / clipPos.w * 0.5 + 0.5) * vec2(uClusterSize.xy);
+				float slice = log(max(-viewPos.z, uClusterDepth.x)) * uClusterDepth.z + uClusterDepth.w;
+				ivec3 cluster = clamp(ivec3(vec3(cell, slice)), ivec3(0), ivec3(uClusterSize.xyz) - 1);
+				return cluster.x + int(uClusterSize.x) * (cluster.y + int(uClusterSize.y) * cluster.z);
+			}
+
+			vec3 ShadeLights(vec3 norm, vec3 viewDir, vec3 fragPos)
+			{
+				vec3 result = vec3(0.0);
+
+				for (int i = 0; i < uLightCount; ++i)
+				{
+					result += ShadeLight(normalize(-uLights[i].direction), uLights[i].color, norm, viewDir);
+				}
+
+				// only the point lights binned into this fragment's cluster
+				if (uClusterSize.w > 0u)
+				{
+					uvec2 range = texelFetch(uClusterGrid, GetClusterIndex(fragPos)).xy;
+					for (uint i = 0u; i < range.y; ++i)
+					{
+						int lightIndex = int(texelFetch(uClusterLightIndices, int(range.x + i)).x);
+						vec4 positionRadius = texelFetch(uPointLights, lightIndex * 2);
+						vec3 lightColor = texelFetch(uPointLights, lightIndex * 2 + 1).rgb;
+
+						vec3 toLight = positionRadius.xyz - fragPos;
+						float lightDistance = length(toLight);
+						float falloff = clamp(1.0 - pow(lightDistance / positionRadius.w, 4.0), 0.0, 1.0);
+						float attenuation = falloff * falloff / (lightDistance * lightDistance + 1.0);
+						result += ShadeLight(toLight / max(lightDistance, 0.0001), lightColor, norm, viewDir) * attenuation;
+					}
+				}
+
 				// ambient
 				const float ambientStrength = 0.4;
-				vec3 ambient = ambientStrength * uLight.color;
+				vec3 ambientColor = uLightCount > 0 ? uLights[0].color : vec3(0.0);
+				result += ambientStrength * ambientColor;
 
-				vec3 result = diffuse + specular + ambient;
+				return result;
+			}
+
+			void main()
+			{
+				vec3 norm = normalize(vNormal);
+				vec3 viewDir = normalize(uCameraPos - vFragPos);
+
+				vec3 result = ShadeLights(norm, viewDir, vFragPos);
 
 				vec4 texColor = texture(baseColorTexture, vUV);
 
@@ -143,44 +226,183 @@ namespace eng
 			}
 			)";
 
-			m_defaultShaderProgram = CreateShaderProgram(vertexShaderSource, fragmentShaderSource);
+			m_defaultShaderProgram = CreateInstancedShaderProgram(vertexShaderSource, fragmentShaderSource);
 		}
 
 		return m_defaultShaderProgram;
 	}
 
-	unsigned int GraphicsAPI::CreateVertexBuffer(const std::vector<float>& vertices)
+	void GraphicsAPI::ReleaseDefaultShaderProgram()
 	{
-		//VERTEX BUFFER OBJECT
-		unsigned int VBO = 0;
-		glGenBuffers(1, &VBO);
-		glBindBuffer(GL_ARRAY_BUFFER, VBO);
-		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		m_defaultShaderProgram.reset();
+	}
 
-		return VBO;
+	void GraphicsAPI::UpdateFrameUniforms(const CameraData& cameraData, const std::vector<LightData>& lights)
+	{
+		m_frameUniforms.view = cameraData.viewMatrix;
+		m_frameUniforms.projection = cameraData.projectionMatrix;
+		m_frameUniforms.cameraPosition = cameraData.position;
+
+		// Directional lights go into the uniform block, point lights into the clusters
+		size_t lightCount = 0;
+		for (const auto& light : lights)
+		{
+			if (light.type != LightType::Directional || lightCount == FrameUniforms::MaxLights)
+			{
+				continue;
+			}
+
+			m_frameUniforms.lights[lightCount].color = glm::vec4(light.color, 1.0f);
+			m_frameUniforms.lights[lightCount].direction = glm::vec4(glm::normalize(-light.position), 0.0f);
+			++lightCount;
+		}
+		m_frameUniforms.lightCount = static_cast<int32_t>(lightCount);
+
+		m_lightClusters.Build(cameraData, lights);
+		m_frameUniforms.clusterSize = glm::uvec4(
+			LightClusters::GridSizeX,
+			LightClusters::GridSizeY,
+			LightClusters::GridSizeZ,
+			m_lightClusters.GetPointLightCount());
+		m_frameUniforms.clusterDepth = glm::vec4(
+			cameraData.nearPlane,
+			cameraData.farPlane,
+			m_lightClusters.GetDepthSliceScale(),
+			m_lightClusters.GetDepthSliceBias());
+
+		// Only the used part of the light array has to be uploaded
+		UploadFrameUniforms(offsetof(FrameUniforms, lights) + lightCount * sizeof(FrameUniforms::Light));
 	}
 
-	unsigned int GraphicsAPI::CreateIndexBuffer(const std::vector<uint32_t>& indices)
+	const LightClusters& GraphicsAPI::GetLightClusters() const
 	{
-		//INDEX BUFFER OBJECT
-		unsigned int EBO = 0;
-		glGenBuffers(1, &EBO);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		return m_lightClusters;
+	}
 
-		return EBO;
+	void GraphicsAPI::UseProgram(unsigned int program)
+	{
+		if (m_state.program == program)
+		{
+			++m_stats.skippedStateCalls;
+			return;
+		}
+
+		ApplyProgram(program);
+		m_state.program = program;
+		++m_stats.issuedStateCalls;
 	}
 
-	void GraphicsAPI::SetClearColor(float r, float g, float b, float a)
+	void GraphicsAPI::BindVertexArray(unsigned int vertexArray)
 	{
-		glClearColor(r, g, b, a);
+		if (m_state.vertexArray == vertexArray)
+		{
+			++m_stats.skippedStateCalls;
+			return;
+		}
+
+		ApplyVertexArray(vertexArray);
+		m_state.vertexArray = vertexArray;
+		++m_stats.issuedStateCalls;
+	}
+
+	void GraphicsAPI::BindTexture(unsigned int unit, unsigned int texture)
+	{
+		if (unit < MaxTextureUnits && m_state.textures[unit] == texture)
+		{
+			++m_stats.skippedStateCalls;
+			return;
+		}
+
+		ApplyTexture(unit, texture);
+		if (unit < MaxTextureUnits)
+		{
+			m_state.textures[unit] = texture;
+		}
+		++m_stats.issuedStateCalls;
+	}
+
+	void GraphicsAPI::SetDepthTestEnabled(bool enabled)
+	{
+		SetCapability(Capability::DepthTest, m_state.depthTest, enabled);
+	}
+
+	void GraphicsAPI::SetBlendEnabled(bool enabled)
+	{
+		SetCapability(Capability::Blend, m_state.blend, enabled);
+	}
+
+	void GraphicsAPI::SetCullFaceEnabled(bool enabled)
+	{
+		SetCapability(Capability::CullFace, m_state.cullFace, enabled);
+	}
+
+	void GraphicsAPI::SetCapability(Capability capability, int& cached, bool enabled)
+	{
+		const int value = enabled ? 1 : 0;
+		if (cached == value)
+		{
+			++m_stats.skippedStateCalls;
+			return;
+		}
+
+		ApplyCapability(capability, enabled);
+		cached = value;
+		++m_stats.issuedStateCalls;
+	}
+
+	void GraphicsAPI::DeleteProgram(unsigned int program)
+	{
+		ReleaseProgram(program);
+		if (m_state.program == program)
+		{
+			// GL keeps a deleted program in use until another one is bound
+			m_state.program = -1;
+		}
 	}
 
-	void GraphicsAPI::ClearBuffers()
+	void GraphicsAPI::DeleteVertexArray(unsigned int vertexArray)
 	{
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		ReleaseVertexArray(vertexArray);
+		if (m_state.vertexArray == vertexArray)
+		{
+			m_state.vertexArray = 0;
+		}
+	}
+
+	void GraphicsAPI::DeleteTexture(unsigned int texture)
+	{
+		ReleaseTexture(texture);
+		for (auto& bound : m_state.textures)
+		{
+			if (bound == texture)
+			{
+				bound = 0;
+			}
+		}
+	}
+
+	void GraphicsAPI::InvalidateStateCache()
+	{
+		m_state = StateCache();
+		for (auto& texture : m_state.textures)
+		{
+			texture = -1;
+		}
+	}
+
+	const GraphicsStats& GraphicsAPI::GetStats() const
+	{
+		return m_stats;
+	}
+
+	void GraphicsAPI::ResetStats()
+	{
+		m_stats = GraphicsStats();
+	}
+
+	const std::vector<GpuPassTiming>& GraphicsAPI::GetGpuPassTimings() const
+	{
+		return m_gpuPassTimings;
 	}
 
 	void GraphicsAPI::BindShaderProgram(ShaderProgram* shaderProgram)
@@ -222,4 +444,12 @@ namespace eng
 			mesh->Draw();
 		}
 	}
+
+	void GraphicsAPI::DrawMeshInstanced(Mesh* mesh, size_t instanceCount)
+	{
+		if (mesh)
+		{
+			mesh->DrawInstanced(instanceCount);
+		}
+	}
 }
\ No newline at end of file
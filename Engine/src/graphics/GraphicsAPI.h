@@ -3,33 +3,218 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <glm/mat4x4.hpp>
+#include "Common.h"
+#include "render/LightClusters.h"
 
 namespace eng
 {
 	class ShaderProgram;
 	class Material;
 	class Mesh;
+	struct VertexLayout;
 
+	// std140 mirror of the FrameData uniform block every engine shader declares:
+	//
+	// struct Light { vec3 color; vec3 direction; };
+	// layout(std140) uniform FrameData
+	// {
+	//     mat4 uView;
+	//     mat4 uProjection;
+	//     vec3 uCameraPos;
+	//     int uLightCount;
+	//     uvec4 uClusterSize;
+	//     vec4 uClusterDepth;
+	//     Light uLights[MAX_LIGHTS];
+	// };
+	//
+	// MAX_LIGHTS is defined for every program created through GraphicsAPI.
+	// uLights holds directional lights only, point lights are read through the cluster buffers:
+	//
+	// uniform usamplerBuffer uClusterGrid;         // per cluster: offset, count
+	// uniform usamplerBuffer uClusterLightIndices;
+	// uniform samplerBuffer uPointLights;          // per light: position and radius, color
+	struct FrameUniforms
+	{
+		static constexpr int MaxLights = 16;
+		static constexpr unsigned int BindingPoint = 0;
+
+		struct Light
+		{
+			glm::vec4 color;
+			glm::vec4 direction;
+		};
+
+		glm::mat4 view;
+		glm::mat4 projection;
+		glm::vec3 cameraPosition;
+		int32_t lightCount;
+		// Cluster grid x, y, z and point light count
+		glm::uvec4 clusterSize;
+		// Near, far, depth slice scale and bias
+		glm::vec4 clusterDepth;
+		Light lights[MaxLights];
+	};
+
+	static_assert(sizeof(FrameUniforms::Light) == 32, "FrameUniforms::Light does not match std140 layout");
+	static_assert(offsetof(FrameUniforms, lights) == 176, "FrameUniforms does not match std140 layout");
+
+	// Counters of the state calls that went through the GraphicsAPI state cache
+	struct GraphicsStats
+	{
+		size_t issuedStateCalls = 0;
+		size_t skippedStateCalls = 0;
+	};
+
+	// GPU time of a named pass, measured with timer queries
+	struct GpuPassTiming
+	{
+		std::string name;
+		double milliseconds = 0.0;
+	};
+
+	enum class Capability
+	{
+		DepthTest,
+		Blend,
+		CullFace
+	};
+
+	// Backend independent front of the renderer. Object creation, uniforms and draws are implemented
+	// by a backend, state changes go through a shared cache that only forwards actual changes.
 	class GraphicsAPI
 	{
 	public:
-		bool Init();
-		std::shared_ptr<ShaderProgram> CreateShaderProgram(const std::string& vertexSource, const std::string& fragmentSource);
+		static constexpr int MaxTextureUnits = 16;
+		// The last units are reserved for the light cluster buffers, materials bind from unit 0 up
+		static constexpr int ClusterGridTextureUnit = MaxTextureUnits - 3;
+		static constexpr int ClusterLightIndicesTextureUnit = MaxTextureUnits - 2;
+		static constexpr int PointLightsTextureUnit = MaxTextureUnits - 1;
+
+		virtual ~GraphicsAPI() = default;
+
+		virtual bool Init() = 0;
+		// defines are injected right after the #version line as "#define <name>"
+		virtual std::shared_ptr<ShaderProgram> CreateShaderProgram(const std::string& vertexSource, const std::string& fragmentSource,
+			const std::vector<std::string>& defines = {}) = 0;
+		// Compiles the program and a second one with INSTANCED defined, linked as its instanced variant
+		std::shared_ptr<ShaderProgram> CreateInstancedShaderProgram(const std::string& vertexSource, const std::string& fragmentSource);
+		// Same sources give the same program as long as someone still uses it, otherwise it is compiled
+		std::shared_ptr<ShaderProgram> GetOrCreateShaderProgram(const std::string& vertexSource, const std::string& fragmentSource, bool instanced = false);
+		// 64 bit FNV-1a over both sources and the defines, stable between runs
+		static uint64_t HashShaderSources(const std::string& vertexSource, const std::string& fragmentSource,
+			const std::vector<std::string>& defines = {});
 		const std::shared_ptr<ShaderProgram>& GetDefaultShaderProgram();
 
-		unsigned int CreateVertexBuffer(const std::vector<float>& vertices);
-		unsigned int CreateIndexBuffer(const std::vector<uint32_t>& indices);
+		// Slow path for uniforms that were not found at link time
+		virtual int GetUniformLocation(unsigned int program, const std::string& name) = 0;
+		// Apply to the currently used program
+		virtual void SetUniform(int location, int value) = 0;
+		virtual void SetUniform(int location, float value) = 0;
+		virtual void SetUniform(int location, float v0, float v1) = 0;
+		virtual void SetUniform(int location, const glm::vec3& value) = 0;
+		virtual void SetUniform(int location, const glm::mat4& value) = 0;
 
-		void SetClearColor(float r, float g, float b, float a);
-		void ClearBuffers();
+		virtual unsigned int CreateVertexBuffer(const std::vector<float>& vertices) = 0;
+		virtual unsigned int CreateIndexBuffer(const std::vector<uint32_t>& indices) = 0;
+		virtual unsigned int CreateInstanceBuffer() = 0;
+		virtual void UpdateInstanceBuffer(unsigned int buffer, const std::vector<glm::mat4>& instances) = 0;
+		// indexBuffer may be 0 for non indexed meshes
+		virtual unsigned int CreateVertexArray(const VertexLayout& layout, unsigned int vertexBuffer, unsigned int indexBuffer) = 0;
+		// Attaches the per instance model matrix attributes of the bound vertex array to the given buffer
+		virtual void SetInstanceAttributes(unsigned int instanceBuffer) = 0;
+		virtual unsigned int CreateTexture(int width, int height, int numChannels, const unsigned char* data) = 0;
+
+		// Draw triangles from the bound vertex array, count is in indices or vertices
+		virtual void Draw(size_t count, bool indexed) = 0;
+		virtual void DrawInstanced(size_t count, bool indexed, size_t instanceCount) = 0;
+
+		// Uploads the per frame constants and binds them to FrameUniforms::BindingPoint,
+		// point lights are binned into the light clusters
+		void UpdateFrameUniforms(const CameraData& cameraData, const std::vector<LightData>& lights);
+		const LightClusters& GetLightClusters() const;
+
+		virtual void SetClearColor(float r, float g, float b, float a) = 0;
+		virtual void ClearBuffers() = 0;
+
+		// Cached state, the backend call is skipped when the value is already current
+		void UseProgram(unsigned int program);
+		void BindVertexArray(unsigned int vertexArray);
+		void BindTexture(unsigned int unit, unsigned int texture);
+		void SetDepthTestEnabled(bool enabled);
+		void SetBlendEnabled(bool enabled);
+		void SetCullFaceEnabled(bool enabled);
+
+		// Deleting through these keeps the state cache from referencing recycled names
+		void DeleteProgram(unsigned int program);
+		void DeleteVertexArray(unsigned int vertexArray);
+		void DeleteTexture(unsigned int texture);
+
+		// Forces every cached state to be reissued, e.g. after external code touched GL directly
+		virtual void InvalidateStateCache();
+
+		const GraphicsStats& GetStats() const;
+		void ResetStats();
+
+		// Timer query ring: a frame's results are read back a few frames later instead of stalling.
+		// Passes do not nest, a pass begun inside another one is not timed.
+		virtual void BeginGpuFrame() = 0;
+		virtual void BeginGpuPass(const std::string& name) = 0;
+		virtual void EndGpuPass() = 0;
+		// Passes of the latest frame whose results came back, empty without timer support
+		const std::vector<GpuPassTiming>& GetGpuPassTimings() const;
 
 		void BindShaderProgram(ShaderProgram* shaderProgram);
 		void BindMaterial(Material* material);
 		void BindMesh(Mesh* mesh);
 		void UnbindMesh(Mesh* mesh);
 		void DrawMesh(Mesh* mesh);
+		void DrawMeshInstanced(Mesh* mesh, size_t instanceCount);
+
+	protected:
+		// Issue the state change, called by the cache only when the value differs
+		virtual void ApplyProgram(unsigned int program) = 0;
+		virtual void ApplyVertexArray(unsigned int vertexArray) = 0;
+		virtual void ApplyTexture(unsigned int unit, unsigned int texture) = 0;
+		virtual void ApplyCapability(Capability capability, bool enabled) = 0;
+
+		virtual void ReleaseProgram(unsigned int program) = 0;
+		virtual void ReleaseVertexArray(unsigned int vertexArray) = 0;
+		virtual void ReleaseTexture(unsigned int texture) = 0;
+
+		// size is the used part of m_frameUniforms, m_lightClusters is already built
+		virtual void UploadFrameUniforms(size_t size) = 0;
+
+		// Backends call this from their destructor, the program still needs them to delete itself
+		void ReleaseDefaultShaderProgram();
 
 	private:
+		void SetCapability(Capability capability, int& cached, bool enabled);
+
+	protected:
+		GraphicsStats m_stats;
+		std::vector<GpuPassTiming> m_gpuPassTimings;
+		FrameUniforms m_frameUniforms;
+		LightClusters m_lightClusters;
+
+	private:
+		// Shadow copy of the backend state, -1 means unknown
+		struct StateCache
+		{
+			long long program = -1;
+			long long vertexArray = -1;
+			long long textures[MaxTextureUnits];
+			int depthTest = -1;
+			int blend = -1;
+			int cullFace = -1;
+		};
+
+		StateCache m_state;
 		std::shared_ptr<ShaderProgram> m_defaultShaderProgram;
+		// Weak, so programs are still deleted when the last material lets go of them
+		std::unordered_map<uint64_t, std::weak_ptr<ShaderProgram>> m_shaderPrograms;
 	};
 }
\ No newline at end of file
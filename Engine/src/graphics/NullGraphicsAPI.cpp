@@ -0,0 +1,175 @@
+#include "graphics/NullGraphicsAPI.h"
+#include "graphics/ShaderProgram.h"
+
+namespace eng
+{
+	NullGraphicsAPI::~NullGraphicsAPI()
+	{
+		ReleaseDefaultShaderProgram();
+	}
+
+	bool NullGraphicsAPI::Init()
+	{
+		InvalidateStateCache();
+		SetDepthTestEnabled(true);
+		return true;
+	}
+
+	std::shared_ptr<ShaderProgram> NullGraphicsAPI::CreateShaderProgram(const std::string& vertexSource, const std::string& fragmentSource,
+		const std::vector<std::string>& defines)
+	{
+		++m_calls.shaderPrograms;
+		// No uniforms, materials resolve every parameter to -1 and skip it
+		return std::make_shared<ShaderProgram>(m_nextName++, std::vector<UniformInfo>());
+	}
+
+	int NullGraphicsAPI::GetUniformLocation(unsigned int program, const std::string& name)
+	{
+		return -1;
+	}
+
+	void NullGraphicsAPI::SetUniform(int location, int value)
+	{
+		++m_calls.uniforms;
+	}
+
+	void NullGraphicsAPI::SetUniform(int location, float value)
+	{
+		++m_calls.uniforms;
+	}
+
+	void NullGraphicsAPI::SetUniform(int location, float v0, float v1)
+	{
+		++m_calls.uniforms;
+	}
+
+	void NullGraphicsAPI::SetUniform(int location, const glm::vec3& value)
+	{
+		++m_calls.uniforms;
+	}
+
+	void NullGraphicsAPI::SetUniform(int location, const glm::mat4& value)
+	{
+		++m_calls.uniforms;
+	}
+
+	unsigned int NullGraphicsAPI::CreateVertexBuffer(const std::vector<float>& vertices)
+	{
+		++m_calls.buffers;
+		++m_calls.bufferUploads;
+		return m_nextName++;
+	}
+
+	unsigned int NullGraphicsAPI::CreateIndexBuffer(const std::vector<uint32_t>& indices)
+	{
+		++m_calls.buffers;
+		++m_calls.bufferUploads;
+		return m_nextName++;
+	}
+
+	unsigned int NullGraphicsAPI::CreateInstanceBuffer()
+	{
+		++m_calls.buffers;
+		return m_nextName++;
+	}
+
+	void NullGraphicsAPI::UpdateInstanceBuffer(unsigned int buffer, const std::vector<glm::mat4>& instances)
+	{
+		++m_calls.bufferUploads;
+	}
+
+	unsigned int NullGraphicsAPI::CreateVertexArray(const VertexLayout& layout, unsigned int vertexBuffer, unsigned int indexBuffer)
+	{
+		++m_calls.vertexArrays;
+		return m_nextName++;
+	}
+
+	void NullGraphicsAPI::SetInstanceAttributes(unsigned int instanceBuffer)
+	{
+		++m_calls.stateChanges;
+	}
+
+	unsigned int NullGraphicsAPI::CreateTexture(int width, int height, int numChannels, const unsigned char* data)
+	{
+		++m_calls.textures;
+		return m_nextName++;
+	}
+
+	void NullGraphicsAPI::Draw(size_t count, bool indexed)
+	{
+		++m_calls.drawCalls;
+	}
+
+	void NullGraphicsAPI::DrawInstanced(size_t count, bool indexed, size_t instanceCount)
+	{
+		++m_calls.instancedDrawCalls;
+		m_calls.instances += instanceCount;
+	}
+
+	void NullGraphicsAPI::SetClearColor(float r, float g, float b, float a)
+	{
+	}
+
+	void NullGraphicsAPI::ClearBuffers()
+	{
+	}
+
+	void NullGraphicsAPI::BeginGpuFrame()
+	{
+	}
+
+	void NullGraphicsAPI::BeginGpuPass(const std::string& name)
+	{
+	}
+
+	void NullGraphicsAPI::EndGpuPass()
+	{
+	}
+
+	const NullGraphicsCalls& NullGraphicsAPI::GetRecordedCalls() const
+	{
+		return m_calls;
+	}
+
+	void NullGraphicsAPI::ResetRecordedCalls()
+	{
+		m_calls = NullGraphicsCalls();
+	}
+
+	void NullGraphicsAPI::ApplyProgram(unsigned int program)
+	{
+		++m_calls.stateChanges;
+	}
+
+	void NullGraphicsAPI::ApplyVertexArray(unsigned int vertexArray)
+	{
+		++m_calls.stateChanges;
+	}
+
+	void NullGraphicsAPI::ApplyTexture(unsigned int unit, unsigned int texture)
+	{
+		++m_calls.stateChanges;
+	}
+
+	void NullGraphicsAPI::ApplyCapability(Capability capability, bool enabled)
+	{
+		++m_calls.stateChanges;
+	}
+
+	void NullGraphicsAPI::ReleaseProgram(unsigned int program)
+	{
+	}
+
+	void NullGraphicsAPI::ReleaseVertexArray(unsigned int vertexArray)
+	{
+	}
+
+	void NullGraphicsAPI::ReleaseTexture(unsigned int texture)
+	{
+	}
+
+	void NullGraphicsAPI::UploadFrameUniforms(size_t size)
+	{
+		++m_calls.frameUploads;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+#include "graphics/GraphicsAPI.h"
+
+namespace eng
+{
+	// What the null backend was asked to do
+	struct NullGraphicsCalls
+	{
+		size_t shaderPrograms = 0;
+		size_t buffers = 0;
+		size_t bufferUploads = 0;
+		size_t vertexArrays = 0;
+		size_t textures = 0;
+		size_t uniforms = 0;
+		size_t stateChanges = 0;
+		size_t frameUploads = 0;
+		size_t drawCalls = 0;
+		size_t instancedDrawCalls = 0;
+		size_t instances = 0;
+	};
+
+	// Backend without a device for headless runs, hands out names and records calls instead of issuing them
+	class NullGraphicsAPI : public GraphicsAPI
+	{
+	public:
+		~NullGraphicsAPI() override;
+
+		bool Init() override;
+		std::shared_ptr<ShaderProgram> CreateShaderProgram(const std::string& vertexSource, const std::string& fragmentSource,
+			const std::vector<std::string>& defines = {}) override;
+
+		int GetUniformLocation(unsigned int program, const std::string& name) override;
+		void SetUniform(int location, int value) override;
+		void SetUniform(int location, float value) override;
+		void SetUniform(int location, float v0, float v1) override;
+		void SetUniform(int location, const glm::vec3& value) override;
+		void SetUniform(int location, const glm::mat4& value) override;
+
+		unsigned int CreateVertexBuffer(const std::vector<float>& vertices) override;
+		unsigned int CreateIndexBuffer(const std::vector<uint32_t>& indices) override;
+		unsigned int CreateInstanceBuffer() override;
+		void UpdateInstanceBuffer(unsigned int buffer, const std::vector<glm::mat4>& instances) override;
+		unsigned int CreateVertexArray(const VertexLayout& layout, unsigned int vertexBuffer, unsigned int indexBuffer) override;
+		void SetInstanceAttributes(unsigned int instanceBuffer) override;
+		unsigned int CreateTexture(int width, int height, int numChannels, const unsigned char* data) override;
+
+		void Draw(size_t count, bool indexed) override;
+		void DrawInstanced(size_t count, bool indexed, size_t instanceCount) override;
+
+		void SetClearColor(float r, float g, float b, float a) override;
+		void ClearBuffers() override;
+
+		void BeginGpuFrame() override;
+		void BeginGpuPass(const std::string& name) override;
+		void EndGpuPass() override;
+
+		const NullGraphicsCalls& GetRecordedCalls() const;
+		void ResetRecordedCalls();
+
+	protected:
+		void ApplyProgram(unsigned int program) override;
+		void ApplyVertexArray(unsigned int vertexArray) override;
+		void ApplyTexture(unsigned int unit, unsigned int texture) override;
+		void ApplyCapability(Capability capability, bool enabled) override;
+
+		void ReleaseProgram(unsigned int program) override;
+		void ReleaseVertexArray(unsigned int vertexArray) override;
+		void ReleaseTexture(unsigned int texture) override;
+
+		void UploadFrameUniforms(size_t size) override;
+
+	private:
+		unsigned int m_nextName = 1;
+		NullGraphicsCalls m_calls;
+	};
+}
\ No newline at end of file
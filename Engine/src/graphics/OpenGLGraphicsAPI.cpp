@@ -0,0 +1,742 @@
+#include "graphics/OpenGLGraphicsAPI.h"
+#include "graphics/ShaderProgram.h"
+#include "graphics/VertexLayout.h"
+#include "profiling/Profiler.h"
+#include <GLFW/glfw3.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// Program binaries are core in 4.1, the loader only covers 3.3 so they are fetched by hand
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+typedef void (APIENTRYP PFN_GETPROGRAMBINARY)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFN_PROGRAMBINARY)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFN_PROGRAMPARAMETERI)(GLuint program, GLenum pname, GLint value);
+
+namespace eng
+{
+	static PFN_GETPROGRAMBINARY getProgramBinary = nullptr;
+	static PFN_PROGRAMBINARY programBinary = nullptr;
+	static PFN_PROGRAMPARAMETERI programParameteri = nullptr;
+
+	// Start of every cached program file, the binary follows
+	struct ProgramBinaryHeader
+	{
+		static constexpr uint32_t Magic = 0x42504745; // "EGPB"
+		static constexpr uint32_t Version = 1;
+
+		uint32_t magic = Magic;
+		uint32_t version = Version;
+		uint64_t sourceHash = 0;
+		uint64_t driverHash = 0;
+		uint32_t format = 0;
+		uint32_t size = 0;
+	};
+
+	static bool HasExtension(const char* name)
+	{
+		int count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+		for (int i = 0; i < count; ++i)
+		{
+			auto extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+			if (extension && std::strcmp(extension, name) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static std::string GetGLString(GLenum name)
+	{
+		auto value = reinterpret_cast<const char*>(glGetString(name));
+		return value ? value : "";
+	}
+	// Buffer texture views on a buffer object, they stay bound to their unit for the whole run
+	static void CreateTextureBuffer(unsigned int& buffer, unsigned int& texture, GLenum format, int unit)
+	{
+		glGenBuffers(1, &buffer);
+		glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+		glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+		glGenTextures(1, &texture);
+		glActiveTexture(GL_TEXTURE0 + unit);
+		glBindTexture(GL_TEXTURE_BUFFER, texture);
+		glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+	}
+
+	static void UploadTextureBuffer(unsigned int buffer, const void* data, size_t size)
+	{
+		glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+		// Orphan the old storage, empty buffers keep a minimum size
+		glBufferData(GL_TEXTURE_BUFFER, std::max<size_t>(size, 16), nullptr, GL_STREAM_DRAW);
+		if (size > 0)
+		{
+			glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data);
+		}
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+	}
+
+	OpenGLGraphicsAPI::~OpenGLGraphicsAPI()
+	{
+		ReleaseDefaultShaderProgram();
+
+		for (auto& frame : m_gpuFrames)
+		{
+			for (const auto& pass : frame)
+			{
+				m_freeQueries.push_back(pass.query);
+			}
+		}
+		if (!m_freeQueries.empty())
+		{
+			glDeleteQueries(static_cast<GLsizei>(m_freeQueries.size()), m_freeQueries.data());
+		}
+
+		// Zero when Init never ran
+		if (m_frameUniformBuffer != 0)
+		{
+			const GLuint buffers[] = { m_frameUniformBuffer, m_clusterGridBuffer, m_clusterLightIndexBuffer, m_pointLightBuffer };
+			const GLuint textures[] = { m_clusterGridTexture, m_clusterLightIndexTexture, m_pointLightTexture };
+			glDeleteTextures(3, textures);
+			glDeleteBuffers(4, buffers);
+		}
+	}
+
+	bool OpenGLGraphicsAPI::Init()
+	{
+		glGenBuffers(1, &m_frameUniformBuffer);
+		glBindBuffer(GL_UNIFORM_BUFFER, m_frameUniformBuffer);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), nullptr, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		glBindBufferBase(GL_UNIFORM_BUFFER, FrameUniforms::BindingPoint, m_frameUniformBuffer);
+
+		CreateTextureBuffer(m_clusterGridBuffer, m_clusterGridTexture, GL_RG32UI, ClusterGridTextureUnit);
+		CreateTextureBuffer(m_clusterLightIndexBuffer, m_clusterLightIndexTexture, GL_R32UI, ClusterLightIndicesTextureUnit);
+		CreateTextureBuffer(m_pointLightBuffer, m_pointLightTexture, GL_RGBA32F, PointLightsTextureUnit);
+		glActiveTexture(GL_TEXTURE0);
+
+		InvalidateStateCache();
+		SetDepthTestEnabled(true);
+
+		int major = 0;
+		int minor = 0;
+		glGetIntegerv(GL_MAJOR_VERSION, &major);
+		glGetIntegerv(GL_MINOR_VERSION, &minor);
+		if (major > 4 || (major == 4 && minor >= 1) || HasExtension("GL_ARB_get_program_binary"))
+		{
+			getProgramBinary = reinterpret_cast<PFN_GETPROGRAMBINARY>(glfwGetProcAddress("glGetProgramBinary"));
+			programBinary = reinterpret_cast<PFN_PROGRAMBINARY>(glfwGetProcAddress("glProgramBinary"));
+			programParameteri = reinterpret_cast<PFN_PROGRAMPARAMETERI>(glfwGetProcAddress("glProgramParameteri"));
+
+			// Drivers may expose the entry points but accept no format
+			int formatCount = 0;
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+			m_programBinarySupported = getProgramBinary && programBinary && programParameteri && formatCount > 0;
+		}
+		m_driverHash = HashShaderSources(GetGLString(GL_VENDOR), GetGLString(GL_RENDERER), { GetGLString(GL_VERSION) });
+
+		return true;
+	}
+
+	void OpenGLGraphicsAPI::SetProgramCacheFolder(const std::filesystem::path& folder)
+	{
+		m_programCacheFolder = folder;
+	}
+
+	static unsigned int CompileShader(unsigned int type, const std::string& source)
+	{
+		unsigned int id = glCreateShader(type);
+		const char* src = source.c_str();
+		glShaderSource(id, 1, &src, nullptr);
+		glCompileShader(id);
+
+		// Error Handling
+		int result;
+		glGetShaderiv(id, GL_COMPILE_STATUS, &result);
+		if (!result)
+		{
+			// error message
+			char message[512];
+			glGetShaderInfoLog(id, 512, nullptr, message);
+			std::cerr << "Failed to compile " << (type == GL_VERTEX_SHADER ? "Vertex" : "Fragment") << " Shader!" << std::endl;
+			std::cerr << message << std::endl;
+		}
+		return id;
+	}
+
+	static std::string InjectDefines(const std::string& source, const std::vector<std::string>& defines)
+	{
+		if (defines.empty())
+		{
+			return source;
+		}
+
+		std::string defineLines;
+		for (auto& define : defines)
+		{
+			defineLines += "#define " + define + "\n";
+		}
+
+		// #version has to stay the first directive
+		size_t insertPos = 0;
+		size_t versionPos = source.find("#version");
+		if (versionPos != std::string::npos)
+		{
+			size_t lineEnd = source.find('\n', versionPos);
+			insertPos = lineEnd == std::string::npos ? source.size() : lineEnd + 1;
+		}
+
+		std::string result = source;
+		if (insertPos == result.size() && (result.empty() || result.back() != '\n'))
+		{
+			result += '\n';
+			insertPos = result.size();
+		}
+		result.insert(insertPos, defineLines);
+		return result;
+	}
+
+	// Active uniforms of the default block, uniform block members have no location and are skipped
+	static std::vector<UniformInfo> GetActiveUniforms(unsigned int program)
+	{
+		std::vector<UniformInfo> uniforms;
+
+		int count = 0;
+		glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+		int maxLength = 0;
+		glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+		std::vector<char> buffer(maxLength > 0 ? maxLength : 1);
+		uniforms.reserve(count);
+
+		for (int i = 0; i < count; ++i)
+		{
+			int length = 0;
+			int size = 0;
+			GLenum type = 0;
+			glGetActiveUniform(program, i, static_cast<int>(buffer.size()), &length, &size, &type, buffer.data());
+
+			std::string name(buffer.data(), length);
+			int location = glGetUniformLocation(program, name.c_str());
+			if (location < 0)
+			{
+				continue;
+			}
+
+			// Arrays are reported as "name[0]"
+			auto bracket = name.find('[');
+			if (bracket != std::string::npos)
+			{
+				name.resize(bracket);
+			}
+
+			uniforms.push_back({ name, location, type, size });
+		}
+
+		return uniforms;
+	}
+
+	std::shared_ptr<ShaderProgram> OpenGLGraphicsAPI::CreateShaderProgram(const std::string& vertexSource, const std::string& fragmentSource,
+		const std::vector<std::string>& defines)
+	{
+		PROFILE_FUNCTION();
+
+		std::vector<std::string> allDefines = defines;
+		allDefines.push_back("MAX_LIGHTS " + std::to_string(FrameUniforms::MaxLights));
+
+		const bool useBinaryCache = m_programBinarySupported && !m_programCacheFolder.empty();
+		const uint64_t sourceHash = HashShaderSources(vertexSource, fragmentSource, allDefines);
+
+		unsigned int shaderProgramID = useBinaryCache ? LoadProgramBinary(sourceHash) : 0;
+		if (shaderProgramID == 0)
+		{
+			shaderProgramID = glCreateProgram();
+			unsigned int vs = CompileShader(GL_VERTEX_SHADER, InjectDefines(vertexSource, allDefines));
+			unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, InjectDefines(fragmentSource, allDefines));
+
+			glAttachShader(shaderProgramID, vs);
+			glAttachShader(shaderProgramID, fs);
+			if (useBinaryCache)
+			{
+				programParameteri(shaderProgramID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+			}
+			glLinkProgram(shaderProgramID);
+			glValidateProgram(shaderProgramID);
+
+			// Error Handling
+			int result = 0;
+			glGetProgramiv(shaderProgramID, GL_LINK_STATUS, &result);
+			if (!result)
+			{
+				// error message
+				char message[512];
+				glGetProgramInfoLog(shaderProgramID, 512, nullptr, message);
+				std::cerr << "Failed to link Shaders!" << message << std::endl;
+				return nullptr;
+			}
+
+			glDeleteShader(vs);
+			glDeleteShader(fs);
+
+			if (useBinaryCache)
+			{
+				SaveProgramBinary(shaderProgramID, sourceHash);
+			}
+		}
+
+		// Block bindings and sampler units are not part of a binary, they are set up either way
+
+		unsigned int frameBlockIndex = glGetUniformBlockIndex(shaderProgramID, "FrameData");
+		if (frameBlockIndex != GL_INVALID_INDEX)
+		{
+			glUniformBlockBinding(shaderProgramID, frameBlockIndex, FrameUniforms::BindingPoint);
+		}
+
+		// Cluster samplers point at their reserved units once, there is nothing to bind per draw
+		const std::pair<const char*, int> clusterSamplers[] =
+		{
+			{ "uClusterGrid", ClusterGridTextureUnit },
+			{ "uClusterLightIndices", ClusterLightIndicesTextureUnit },
+			{ "uPointLights", PointLightsTextureUnit }
+		};
+		for (const auto& sampler : clusterSamplers)
+		{
+			int location = glGetUniformLocation(shaderProgramID, sampler.first);
+			if (location >= 0)
+			{
+				UseProgram(shaderProgramID);
+				glUniform1i(location, sampler.second);
+			}
+		}
+
+		return std::make_shared<ShaderProgram>(shaderProgramID, GetActiveUniforms(shaderProgramID));
+	}
+
+	unsigned int OpenGLGraphicsAPI::LoadProgramBinary(uint64_t sourceHash)
+	{
+		std::ifstream file(GetProgramBinaryPath(sourceHash), std::ios::binary);
+		if (!file)
+		{
+			return 0;
+		}
+
+		ProgramBinaryHeader header;
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+			header.magic != ProgramBinaryHeader::Magic || header.version != ProgramBinaryHeader::Version ||
+			header.sourceHash != sourceHash || header.driverHash != m_driverHash || header.size == 0)
+		{
+			// Another driver or an old file, compiled again and overwritten
+			return 0;
+		}
+
+		std::vector<char> binary(header.size);
+		if (!file.read(binary.data(), binary.size()))
+		{
+			return 0;
+		}
+
+		unsigned int program = glCreateProgram();
+		programBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+		// The driver may still reject a binary it wrote itself, e.g. after an update keeping its version string
+		int result = 0;
+		glGetProgramiv(program, GL_LINK_STATUS, &result);
+		if (!result)
+		{
+			glDeleteProgram(program);
+			return 0;
+		}
+		return program;
+	}
+
+	void OpenGLGraphicsAPI::SaveProgramBinary(unsigned int program, uint64_t sourceHash)
+	{
+		int length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0)
+		{
+			return;
+		}
+
+		std::vector<char> binary(length);
+		GLenum format = 0;
+		getProgramBinary(program, length, &length, &format, binary.data());
+
+		std::error_code error;
+		std::filesystem::create_directories(m_programCacheFolder, error);
+		std::ofstream file(GetProgramBinaryPath(sourceHash), std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			std::cerr << "Failed to write program binary to " << m_programCacheFolder.string() << std::endl;
+			return;
+		}
+
+		ProgramBinaryHeader header;
+		header.sourceHash = sourceHash;
+		header.driverHash = m_driverHash;
+		header.format = format;
+		header.size = static_cast<uint32_t>(length);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(binary.data(), length);
+	}
+
+	std::filesystem::path OpenGLGraphicsAPI::GetProgramBinaryPath(uint64_t sourceHash) const
+	{
+		char name[32];
+		std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(sourceHash));
+		return m_programCacheFolder / name;
+	}
+
+	int OpenGLGraphicsAPI::GetUniformLocation(unsigned int program, const std::string& name)
+	{
+		return glGetUniformLocation(program, name.c_str());
+	}
+
+	void OpenGLGraphicsAPI::SetUniform(int location, int value)
+	{
+		glUniform1i(location, value);
+	}
+
+	void OpenGLGraphicsAPI::SetUniform(int location, float value)
+	{
+		glUniform1f(location, value);
+	}
+
+	void OpenGLGraphicsAPI::SetUniform(int location, float v0, float v1)
+	{
+		glUniform2f(location, v0, v1);
+	}
+
+	void OpenGLGraphicsAPI::SetUniform(int location, const glm::vec3& value)
+	{
+		glUniform3fv(location, 1, glm::value_ptr(value));
+	}
+
+	void OpenGLGraphicsAPI::SetUniform(int location, const glm::mat4& value)
+	{
+		glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+	}
+
+	unsigned int OpenGLGraphicsAPI::CreateVertexBuffer(const std::vector<float>& vertices)
+	{
+		//VERTEX BUFFER OBJECT
+		unsigned int VBO = 0;
+		glGenBuffers(1, &VBO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		return VBO;
+	}
+
+	unsigned int OpenGLGraphicsAPI::CreateIndexBuffer(const std::vector<uint32_t>& indices)
+	{
+		//INDEX BUFFER OBJECT
+		unsigned int EBO = 0;
+		glGenBuffers(1, &EBO);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+		return EBO;
+	}
+
+	unsigned int OpenGLGraphicsAPI::CreateInstanceBuffer()
+	{
+		unsigned int buffer = 0;
+		glGenBuffers(1, &buffer);
+		return buffer;
+	}
+
+	void OpenGLGraphicsAPI::UpdateInstanceBuffer(unsigned int buffer, const std::vector<glm::mat4>& instances)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+		// Orphan the previous storage so the driver does not have to wait for draws still reading it
+		glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(glm::mat4), instances.data());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	unsigned int OpenGLGraphicsAPI::CreateVertexArray(const VertexLayout& layout, unsigned int vertexBuffer, unsigned int indexBuffer)
+	{
+		unsigned int vertexArray = 0;
+		glGenVertexArrays(1, &vertexArray);
+		BindVertexArray(vertexArray);
+
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+
+		for (auto& element : layout.elements)
+		{
+			glVertexAttribPointer(element.index, element.size, element.type, GL_FALSE, layout.stride, (void*)(uintptr_t)element.offset);
+			glEnableVertexAttribArray(element.index);
+		}
+
+		if (indexBuffer != 0)
+		{
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+		}
+
+		BindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+		return vertexArray;
+	}
+
+	void OpenGLGraphicsAPI::SetInstanceAttributes(unsigned int instanceBuffer)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+		for (int i = 0; i < 4; ++i)
+		{
+			const unsigned int index = VertexElement::InstanceModelIndex + i;
+			glVertexAttribPointer(index, 4, GL_FLOAT, GL_FALSE, sizeof(float) * 16, (void*)(uintptr_t)(sizeof(float) * 4 * i));
+			glEnableVertexAttribArray(index);
+			glVertexAttribDivisor(index, 1);
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	unsigned int OpenGLGraphicsAPI::CreateTexture(int width, int height, int numChannels, const unsigned char* data)
+	{
+		unsigned int texture = 0;
+		glGenTextures(1, &texture);
+		BindTexture(0, texture);
+
+		GLint internalFormat = GL_RGB;
+		GLenum format = GL_RGB;
+
+		if (numChannels == 4)
+		{
+			internalFormat = GL_RGBA;
+			format = GL_RGBA;
+		}
+
+		// Rows are tightly packed, an RGB image or a reduced mip is not always 4-byte aligned
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+		glGenerateMipmap(GL_TEXTURE_2D);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		return texture;
+	}
+
+	void OpenGLGraphicsAPI::Draw(size_t count, bool indexed)
+	{
+		if (indexed)
+		{
+			glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(count), GL_UNSIGNED_INT, 0);
+		}
+		else
+		{
+			glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(count));
+		}
+	}
+
+	void OpenGLGraphicsAPI::DrawInstanced(size_t count, bool indexed, size_t instanceCount)
+	{
+		if (indexed)
+		{
+			glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(count), GL_UNSIGNED_INT, 0, static_cast<GLsizei>(instanceCount));
+		}
+		else
+		{
+			glDrawArraysInstanced(GL_TRIANGLES, 0, static_cast<GLsizei>(count), static_cast<GLsizei>(instanceCount));
+		}
+	}
+
+	void OpenGLGraphicsAPI::SetClearColor(float r, float g, float b, float a)
+	{
+		glClearColor(r, g, b, a);
+	}
+
+	void OpenGLGraphicsAPI::ClearBuffers()
+	{
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	}
+
+	void OpenGLGraphicsAPI::BeginGpuFrame()
+	{
+		// Close a pass left open by the previous frame
+		if (m_gpuPassDepth > 0)
+		{
+			m_gpuPassDepth = 1;
+			EndGpuPass();
+		}
+
+		m_gpuFrameIndex = (m_gpuFrameIndex + 1) % GpuTimerFrames;
+
+		// Oldest frame first, so the newest completed frame ends up in m_gpuPassTimings
+		for (size_t i = 0; i < GpuTimerFrames; ++i)
+		{
+			auto& frame = m_gpuFrames[(m_gpuFrameIndex + i) % GpuTimerFrames];
+			if (frame.empty())
+			{
+				continue;
+			}
+
+			// Queries finish in order, the last one being available means the whole frame is.
+			// The slot about to be reused is dropped if still in flight rather than waited for.
+			int available = GL_FALSE;
+			glGetQueryObjectiv(frame.back().query, GL_QUERY_RESULT_AVAILABLE, &available);
+			if (available == GL_TRUE || i == 0)
+			{
+				CollectGpuTimings(frame, available == GL_TRUE);
+			}
+		}
+	}
+
+	void OpenGLGraphicsAPI::BeginGpuPass(const std::string& name)
+	{
+		if (m_gpuPassDepth++ > 0)
+		{
+			return;
+		}
+
+		unsigned int query = 0;
+		if (m_freeQueries.empty())
+		{
+			glGenQueries(1, &query);
+		}
+		else
+		{
+			query = m_freeQueries.back();
+			m_freeQueries.pop_back();
+		}
+
+		glBeginQuery(GL_TIME_ELAPSED, query);
+		m_gpuFrames[m_gpuFrameIndex].push_back({ name, query });
+	}
+
+	void OpenGLGraphicsAPI::EndGpuPass()
+	{
+		if (m_gpuPassDepth == 0 || --m_gpuPassDepth > 0)
+		{
+			return;
+		}
+
+		glEndQuery(GL_TIME_ELAPSED);
+	}
+
+	void OpenGLGraphicsAPI::CollectGpuTimings(std::vector<GpuPassQuery>& frame, bool available)
+	{
+		if (available)
+		{
+			m_gpuPassTimings.clear();
+			for (const auto& pass : frame)
+			{
+				GLuint64 elapsed = 0;
+				glGetQueryObjectui64v(pass.query, GL_QUERY_RESULT, &elapsed);
+				m_gpuPassTimings.push_back({ pass.name, static_cast<double>(elapsed) / 1000000.0 });
+			}
+		}
+
+		for (const auto& pass : frame)
+		{
+			m_freeQueries.push_back(pass.query);
+		}
+		frame.clear();
+	}
+
+	void OpenGLGraphicsAPI::InvalidateStateCache()
+	{
+		GraphicsAPI::InvalidateStateCache();
+		m_activeTextureUnit = -1;
+	}
+
+	void OpenGLGraphicsAPI::ApplyProgram(unsigned int program)
+	{
+		glUseProgram(program);
+	}
+
+	void OpenGLGraphicsAPI::ApplyVertexArray(unsigned int vertexArray)
+	{
+		glBindVertexArray(vertexArray);
+	}
+
+	void OpenGLGraphicsAPI::ApplyTexture(unsigned int unit, unsigned int texture)
+	{
+		if (m_activeTextureUnit != static_cast<int>(unit))
+		{
+			glActiveTexture(GL_TEXTURE0 + unit);
+			m_activeTextureUnit = static_cast<int>(unit);
+			++m_stats.issuedStateCalls;
+		}
+
+		glBindTexture(GL_TEXTURE_2D, texture);
+	}
+
+	void OpenGLGraphicsAPI::ApplyCapability(Capability capability, bool enabled)
+	{
+		GLenum cap = GL_DEPTH_TEST;
+		switch (capability)
+		{
+		case Capability::DepthTest:
+			cap = GL_DEPTH_TEST;
+			break;
+		case Capability::Blend:
+			cap = GL_BLEND;
+			break;
+		case Capability::CullFace:
+			cap = GL_CULL_FACE;
+			break;
+		}
+
+		if (enabled)
+		{
+			glEnable(cap);
+		}
+		else
+		{
+			glDisable(cap);
+		}
+	}
+
+	void OpenGLGraphicsAPI::ReleaseProgram(unsigned int program)
+	{
+		glDeleteProgram(program);
+	}
+
+	void OpenGLGraphicsAPI::ReleaseVertexArray(unsigned int vertexArray)
+	{
+		glDeleteVertexArrays(1, &vertexArray);
+	}
+
+	void OpenGLGraphicsAPI::ReleaseTexture(unsigned int texture)
+	{
+		glDeleteTextures(1, &texture);
+	}
+
+	void OpenGLGraphicsAPI::UploadFrameUniforms(size_t size)
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, m_frameUniformBuffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, size, &m_frameUniforms);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+		const auto& ranges = m_lightClusters.GetClusterRanges();
+		const auto& indices = m_lightClusters.GetLightIndices();
+		const auto& pointLights = m_lightClusters.GetPointLights();
+		UploadTextureBuffer(m_clusterGridBuffer, ranges.data(), ranges.size() * sizeof(uint32_t));
+		UploadTextureBuffer(m_clusterLightIndexBuffer, indices.data(), indices.size() * sizeof(uint32_t));
+		UploadTextureBuffer(m_pointLightBuffer, pointLights.data(), pointLights.size() * sizeof(glm::vec4));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+#include "graphics/GraphicsAPI.h"
+#include <filesystem>
+
+namespace eng
+{
+	// OpenGL 3.3 core backend, expects a current context with glad loaded
+	class OpenGLGraphicsAPI : public GraphicsAPI
+	{
+	public:
+		~OpenGLGraphicsAPI() override;
+
+		bool Init() override;
+		// Linked programs are stored here and loaded instead of compiled on later runs when the driver
+		// supports program binaries. Empty disables the cache. Call before creating programs.
+		void SetProgramCacheFolder(const std::filesystem::path& folder);
+		std::shared_ptr<ShaderProgram> CreateShaderProgram(const std::string& vertexSource, const std::string& fragmentSource,
+			const std::vector<std::string>& defines = {}) override;
+
+		int GetUniformLocation(unsigned int program, const std::string& name) override;
+		void SetUniform(int location, int value) override;
+		void SetUniform(int location, float value) override;
+		void SetUniform(int location, float v0, float v1) override;
+		void SetUniform(int location, const glm::vec3& value) override;
+		void SetUniform(int location, const glm::mat4& value) override;
+
+		unsigned int CreateVertexBuffer(const std::vector<float>& vertices) override;
+		unsigned int CreateIndexBuffer(const std::vector<uint32_t>& indices) override;
+		unsigned int CreateInstanceBuffer() override;
+		void UpdateInstanceBuffer(unsigned int buffer, const std::vector<glm::mat4>& instances) override;
+		unsigned int CreateVertexArray(const VertexLayout& layout, unsigned int vertexBuffer, unsigned int indexBuffer) override;
+		void SetInstanceAttributes(unsigned int instanceBuffer) override;
+		unsigned int CreateTexture(int width, int height, int numChannels, const unsigned char* data) override;
+
+		void Draw(size_t count, bool indexed) override;
+		void DrawInstanced(size_t count, bool indexed, size_t instanceCount) override;
+
+		void SetClearColor(float r, float g, float b, float a) override;
+		void ClearBuffers() override;
+
+		void BeginGpuFrame() override;
+		void BeginGpuPass(const std::string& name) override;
+		void EndGpuPass() override;
+
+		void InvalidateStateCache() override;
+
+	protected:
+		void ApplyProgram(unsigned int program) override;
+		void ApplyVertexArray(unsigned int vertexArray) override;
+		void ApplyTexture(unsigned int unit, unsigned int texture) override;
+		void ApplyCapability(Capability capability, bool enabled) override;
+
+		void ReleaseProgram(unsigned int program) override;
+		void ReleaseVertexArray(unsigned int vertexArray) override;
+		void ReleaseTexture(unsigned int texture) override;
+
+		void UploadFrameUniforms(size_t size) override;
+
+	private:
+		// Frames a query stays in flight before its slot is reused
+		static constexpr size_t GpuTimerFrames = 4;
+
+		struct GpuPassQuery
+		{
+			std::string name;
+			unsigned int query = 0;
+		};
+
+		// Reads the results when available and recycles the queries
+		void CollectGpuTimings(std::vector<GpuPassQuery>& frame, bool available);
+
+		// 0 when there is no usable binary for this source and driver
+		unsigned int LoadProgramBinary(uint64_t sourceHash);
+		void SaveProgramBinary(unsigned int program, uint64_t sourceHash);
+		std::filesystem::path GetProgramBinaryPath(uint64_t sourceHash) const;
+
+	private:
+		int m_activeTextureUnit = -1;
+
+		bool m_programBinarySupported = false;
+		// Vendor, renderer and version, a binary from another driver is compiled again
+		uint64_t m_driverHash = 0;
+		std::filesystem::path m_programCacheFolder;
+
+		std::vector<GpuPassQuery> m_gpuFrames[GpuTimerFrames];
+		size_t m_gpuFrameIndex = 0;
+		std::vector<unsigned int> m_freeQueries;
+		int m_gpuPassDepth = 0;
+
+		unsigned int m_frameUniformBuffer = 0;
+		unsigned int m_clusterGridBuffer = 0;
+		unsigned int m_clusterGridTexture = 0;
+		unsigned int m_clusterLightIndexBuffer = 0;
+		unsigned int m_clusterLightIndexTexture = 0;
+		unsigned int m_pointLightBuffer = 0;
+		unsigned int m_pointLightTexture = 0;
+	};
+}
\ No newline at end of file
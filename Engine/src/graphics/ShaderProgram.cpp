@@ -1,25 +1,49 @@
 #include "ShaderProgram.h"
 #include "graphics/Texture.h"
-#include <glm/gtc/type_ptr.hpp>
+#include "graphics/GraphicsAPI.h"
+#include "Engine.h"
 
 namespace eng
 {
-	ShaderProgram::ShaderProgram(unsigned int shaderProgramID) : m_shaderProgramID(shaderProgramID)
+	ShaderProgram::ShaderProgram(unsigned int shaderProgramID, std::vector<UniformInfo> uniforms)
+		: m_uniforms(std::move(uniforms)), m_shaderProgramID(shaderProgramID)
 	{
-
+		for (const auto& uniform : m_uniforms)
+		{
+			m_uniformLocationCache[uniform.name] = uniform.location;
+			if (uniform.size > 1)
+			{
+				m_uniformLocationCache[uniform.name + "[0]"] = uniform.location;
+			}
+		}
 	}
 
 	ShaderProgram::~ShaderProgram()
 	{
-		glDeleteProgram(m_shaderProgramID);
+		Engine::GetInstance().GetGraphicsAPI().DeleteProgram(m_shaderProgramID);
 	}
 
 	void ShaderProgram::Bind()
 	{
-		glUseProgram(m_shaderProgramID);
+		Engine::GetInstance().GetGraphicsAPI().UseProgram(m_shaderProgramID);
+		m_currentTextureUnit = 0;
+	}
+
+	unsigned int ShaderProgram::GetID() const
+	{
+		return m_shaderProgramID;
+	}
+
+	void ShaderProgram::ResetTextureUnits()
+	{
 		m_currentTextureUnit = 0;
 	}
 
+	const std::vector<UniformInfo>& ShaderProgram::GetUniforms() const
+	{
+		return m_uniforms;
+	}
+
 	int ShaderProgram::GetUniformLocation(const std::string& name)
 	{
 		auto it = m_uniformLocationCache.find(name);
@@ -28,43 +52,78 @@ namespace eng
 			return it->second;
 		}
 
-		int location = glGetUniformLocation(m_shaderProgramID, name.c_str());
+		int location = Engine::GetInstance().GetGraphicsAPI().GetUniformLocation(m_shaderProgramID, name);
 		m_uniformLocationCache[name] = location;
 
 		return location;
 	}
 
+	void ShaderProgram::SetUniform(int location, float value)
+	{
+		Engine::GetInstance().GetGraphicsAPI().SetUniform(location, value);
+	}
+
+	void ShaderProgram::SetUniform(int location, float v0, float v1)
+	{
+		Engine::GetInstance().GetGraphicsAPI().SetUniform(location, v0, v1);
+	}
+
+	void ShaderProgram::SetUniform(int location, const glm::mat4& mat)
+	{
+		Engine::GetInstance().GetGraphicsAPI().SetUniform(location, mat);
+	}
+
+	void ShaderProgram::SetUniform(int location, const glm::vec3& value)
+	{
+		Engine::GetInstance().GetGraphicsAPI().SetUniform(location, value);
+	}
+
+	void ShaderProgram::SetTexture(int location, Texture* texture)
+	{
+		// Samplers the program doesn't use don't take a texture unit
+		if (location < 0 || !texture)
+		{
+			return;
+		}
+
+		auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
+		graphicsAPI.BindTexture(m_currentTextureUnit, texture->GetID());
+		graphicsAPI.SetUniform(location, m_currentTextureUnit);
+		++m_currentTextureUnit;
+	}
+
 	void ShaderProgram::SetUniform(const std::string& name, float value)
 	{
-		auto location = GetUniformLocation(name);
-		glUniform1f(location, value);
+		SetUniform(GetUniformLocation(name), value);
 	}
 
 	void ShaderProgram::SetUniform(const std::string& name, float v0, float v1)
 	{
-		auto location = GetUniformLocation(name);
-		glUniform2f(location, v0, v1);
+		SetUniform(GetUniformLocation(name), v0, v1);
 	}
 
 	void ShaderProgram::SetUniform(const std::string& name, const glm::mat4& mat)
 	{
-		auto location = GetUniformLocation(name);
-		glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+		SetUniform(GetUniformLocation(name), mat);
 	}
 
 	void ShaderProgram::SetUniform(const std::string& name, const glm::vec3& value)
 	{
-		auto location = GetUniformLocation(name);
-		glUniform3fv(location, 1, glm::value_ptr(value));
+		SetUniform(GetUniformLocation(name), value);
 	}
 
 	void ShaderProgram::SetTexture(const std::string& name, Texture* texture)
 	{
-		auto location = GetUniformLocation(name);
+		SetTexture(GetUniformLocation(name), texture);
+	}
 
-		glActiveTexture(GL_TEXTURE0 + m_currentTextureUnit);
-		glBindTexture(GL_TEXTURE_2D, texture->GetID());
-		glUniform1i(location, m_currentTextureUnit);
-		++m_currentTextureUnit;
+	void ShaderProgram::SetInstancedVariant(const std::shared_ptr<ShaderProgram>& variant)
+	{
+		m_instancedVariant = variant;
+	}
+
+	ShaderProgram* ShaderProgram::GetInstancedVariant() const
+	{
+		return m_instancedVariant.get();
 	}
 }
\ No newline at end of file
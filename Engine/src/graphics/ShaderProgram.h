@@ -2,31 +2,62 @@
 #include <glad/glad.h>
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include <memory>
 #include <glm/mat4x4.hpp>
 
 namespace eng
 {
 	class Texture;
+
+	// Active uniform of the default block, read once after linking
+	struct UniformInfo
+	{
+		std::string name;
+		int location = -1;
+		unsigned int type = 0;
+		int size = 0;
+	};
+
 	class ShaderProgram
 	{
 	public:
 		ShaderProgram() = delete;
 		ShaderProgram(const ShaderProgram&) = delete;
 		ShaderProgram& operator = (const ShaderProgram&) = delete;
-		explicit ShaderProgram(unsigned int shaderProgramID);
+		// uniforms are the active uniforms the backend found after linking
+		ShaderProgram(unsigned int shaderProgramID, std::vector<UniformInfo> uniforms);
 		~ShaderProgram();
 
 		void Bind();
+		unsigned int GetID() const;
+		void ResetTextureUnits();
+		const std::vector<UniformInfo>& GetUniforms() const;
 		int GetUniformLocation(const std::string& name);
+
+		// Fast path, locations resolved up front with GetUniformLocation
+		void SetUniform(int location, float value);
+		void SetUniform(int location, float v0, float v1);
+		void SetUniform(int location, const glm::mat4& mat);
+		void SetUniform(int location, const glm::vec3& value);
+		void SetTexture(int location, Texture* texture);
+
+		// Slow path by name, for gameplay code
 		void SetUniform(const std::string& name, float value);
 		void SetUniform(const std::string& name, float v0, float v1);
 		void SetUniform(const std::string& name, const glm::mat4& mat);
 		void SetUniform(const std::string& name, const glm::vec3& value);
 		void SetTexture(const std::string& name, Texture* texture);
 
+		// Same program compiled with INSTANCED defined, model matrices come from a per instance attribute
+		void SetInstancedVariant(const std::shared_ptr<ShaderProgram>& variant);
+		ShaderProgram* GetInstancedVariant() const;
+
 	private:
+		std::vector<UniformInfo> m_uniforms;
 		std::unordered_map<std::string, int> m_uniformLocationCache;
 		unsigned int m_shaderProgramID = 0;
 		int m_currentTextureUnit = 0;
+		std::shared_ptr<ShaderProgram> m_instancedVariant;
 	};
 }
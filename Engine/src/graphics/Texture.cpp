@@ -1,11 +1,63 @@
 #include "Texture.h"
 #include "Engine.h"
+#include "profiling/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image/stb_image.h>
 
 namespace eng
 {
+	static int MipSize(int size, int mip)
+	{
+		return std::max(1, size >> mip);
+	}
+
+	// The image of the mip and the chain below it
+	static int64_t MipChainBytes(int width, int height, int numChannels, int mip)
+	{
+		const int64_t levelBytes = static_cast<int64_t>(MipSize(width, mip)) * MipSize(height, mip) * numChannels;
+		return levelBytes * 4 / 3;
+	}
+
+	static int InitialMip(int width, int height)
+	{
+		int mip = 0;
+		while (MipSize(std::max(width, height), mip) > TextureManager::StreamingInitialSize)
+		{
+			++mip;
+		}
+		return mip;
+	}
+
+	// 2x2 box filter into the start of the same buffer, every pixel is read before it is overwritten
+	static void HalveImage(unsigned char* data, int& width, int& height, int numChannels)
+	{
+		const int halfWidth = std::max(1, width / 2);
+		const int halfHeight = std::max(1, height / 2);
+		for (int y = 0; y < halfHeight; ++y)
+		{
+			const int y0 = std::min(y * 2, height - 1);
+			const int y1 = std::min(y * 2 + 1, height - 1);
+			for (int x = 0; x < halfWidth; ++x)
+			{
+				const int x0 = std::min(x * 2, width - 1);
+				const int x1 = std::min(x * 2 + 1, width - 1);
+				for (int c = 0; c < numChannels; ++c)
+				{
+					const int sum =
+						data[(y0 * width + x0) * numChannels + c] + data[(y0 * width + x1) * numChannels + c] +
+						data[(y1 * width + x0) * numChannels + c] + data[(y1 * width + x1) * numChannels + c];
+					data[(y * halfWidth + x) * numChannels + c] = static_cast<unsigned char>((sum + 2) / 4);
+				}
+			}
+		}
+		width = halfWidth;
+		height = halfHeight;
+	}
+
 	Texture::Texture(int width, int height, int numChannels, unsigned char* data)
 		: m_width(width), m_height(height), m_numChannels(numChannels)
 	{
@@ -16,37 +68,36 @@ namespace eng
 	{
 		if (m_textureID > 0)
 		{
-			glDeleteTextures(1, &m_textureID);
+			Engine::GetInstance().GetGraphicsAPI().DeleteTexture(m_textureID);
 		}
 	}
 	
 	unsigned int Texture::GetID() const
 	{
-		return m_textureID;
+		return m_textureID > 0 ? m_textureID : m_placeholderID;
 	}
 
-	void Texture::Init(int width, int height, int numChannels, unsigned char* data)
+	bool Texture::IsLoaded() const
 	{
-		glGenTextures(1, &m_textureID);
-		glBindTexture(GL_TEXTURE_2D, m_textureID);
-
-		GLint internalFormat = GL_RGB;
-		GLenum format = GL_RGB;
+		return m_textureID > 0;
+	}
 
-		if (numChannels == 4)
+	void Texture::Init(int width, int height, int numChannels, unsigned char* data)
+	{
+		if (m_textureID > 0)
 		{
-			internalFormat = GL_RGBA;
-			format = GL_RGBA;
+			Engine::GetInstance().GetGraphicsAPI().DeleteTexture(m_textureID);
 		}
 
-		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		m_width = width;
+		m_height = height;
+		m_numChannels = numChannels;
+		m_textureID = Engine::GetInstance().GetGraphicsAPI().CreateTexture(width, height, numChannels, data);
+	}
 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	void Texture::RequestScreenSize(float pixels)
+	{
+		m_requestedScreenSize = std::max(m_requestedScreenSize, pixels);
 	}
 
 	std::shared_ptr<Texture> Texture::Load(const std::string path)
@@ -74,16 +125,347 @@ namespace eng
 		return result;
 	}
 
+	TextureManager::~TextureManager()
+	{
+		// Decode jobs still in flight write into this manager
+		Engine::GetInstance().GetJobSystem().Wait(m_decodes);
+		CollectDecoded();
+		for (auto& image : m_uploads)
+		{
+			stbi_image_free(image.data);
+		}
+	}
+
 	std::shared_ptr<Texture> TextureManager::GetOrLoadTexture(const std::string& path)
 	{
 		auto it = m_textures.find(path);
 		if (it != m_textures.end())
 		{
-			return it->second;
+			if (auto texture = it->second.lock())
+			{
+				return texture;
+			}
+		}
+
+		auto fullPath = Engine::GetInstance().GetFileSystem().GetAssetsFolder() / path;
+		if (!std::filesystem::exists(fullPath))
+		{
+			return nullptr;
 		}
 
-		auto texture = Texture::Load(path);
+		auto texture = std::make_shared<Texture>();
+		texture->m_placeholderID = GetPlaceholderID();
 		m_textures[path] = texture;
+		++m_pendingCount;
+
+		DecodedImage request;
+		request.texture = texture;
+		request.path = path;
+		if (m_streamingEnabled)
+		{
+			texture->m_streamed = true;
+			texture->m_file = fullPath.string();
+			request.mip = -1;
+			m_streamed.push_back(texture);
+		}
+		Engine::GetInstance().GetJobSystem().Run([this, request, file = fullPath.string()]()
+			{
+				Decode(request, file);
+			}, &m_decodes);
+
 		return texture;
 	}
+
+	void TextureManager::Decode(DecodedImage request, const std::string& file)
+	{
+		PROFILE_SCOPE("TextureManager::Decode");
+		request.data = stbi_load(file.c_str(), &request.width, &request.height, &request.numChannels, 0);
+		request.fullWidth = request.width;
+		request.fullHeight = request.height;
+
+		// stb_image only decodes full images, smaller mips are reduced from it
+		if (request.data && request.mip != 0)
+		{
+			if (request.mip < 0)
+			{
+				request.mip = InitialMip(request.width, request.height);
+			}
+			for (int mip = 0; mip < request.mip; ++mip)
+			{
+				HalveImage(request.data, request.width, request.height, request.numChannels);
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(m_decodedMutex);
+		m_decoded.push_back(std::move(request));
+	}
+
+	void TextureManager::Update()
+	{
+		if (m_streamingEnabled)
+		{
+			UpdateStreaming();
+		}
+
+		if (m_pendingCount == 0)
+		{
+			return;
+		}
+
+		PROFILE_SCOPE("TextureManager::Update");
+		CollectDecoded();
+
+		// Always one upload, so a single image bigger than the budget still gets through
+		const auto start = std::chrono::steady_clock::now();
+		while (!m_uploads.empty())
+		{
+			Upload(m_uploads.front());
+			m_uploads.pop_front();
+
+			const float elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+			if (elapsed >= m_uploadBudget)
+			{
+				break;
+			}
+		}
+	}
+
+	void TextureManager::SetUploadBudget(float milliseconds)
+	{
+		m_uploadBudget = milliseconds;
+	}
+
+	void TextureManager::FinishPendingLoads()
+	{
+		PROFILE_SCOPE("TextureManager::FinishPendingLoads");
+
+		Engine::GetInstance().GetJobSystem().Wait(m_decodes);
+		CollectDecoded();
+		while (!m_uploads.empty())
+		{
+			Upload(m_uploads.front());
+			m_uploads.pop_front();
+		}
+	}
+
+	size_t TextureManager::GetPendingCount() const
+	{
+		return m_pendingCount;
+	}
+
+	void TextureManager::SetStreamingEnabled(bool enabled)
+	{
+		m_streamingEnabled = enabled;
+	}
+
+	bool TextureManager::IsStreamingEnabled() const
+	{
+		return m_streamingEnabled;
+	}
+
+	void TextureManager::SetStreamingBudget(size_t bytes)
+	{
+		m_streamingBudget = bytes;
+	}
+
+	size_t TextureManager::GetStreamedBytes() const
+	{
+		return m_streamedBytes;
+	}
+
+	void TextureManager::UpdateStreaming()
+	{
+		PROFILE_SCOPE("TextureManager::UpdateStreaming");
+		++m_frame;
+
+		// Resident bytes are summed up again every frame, so textures that went away drop out by themselves
+		int64_t residentBytes = 0;
+		m_upgradeCandidates.clear();
+		m_evictCandidates.clear();
+		for (size_t i = 0; i < m_streamed.size();)
+		{
+			auto texture = m_streamed[i].lock();
+			if (!texture)
+			{
+				m_streamed[i] = std::move(m_streamed.back());
+				m_streamed.pop_back();
+				continue;
+			}
+			++i;
+
+			// The first decode is not back yet
+			if (texture->m_residentMip < 0)
+			{
+				continue;
+			}
+
+			const int width = texture->m_fullWidth;
+			const int height = texture->m_fullHeight;
+			residentBytes += MipChainBytes(width, height, texture->m_numChannels, texture->m_residentMip);
+
+			// Smallest mip that still has at least as many texels as the texture covers pixels
+			const int initialMip = InitialMip(width, height);
+			if (texture->m_requestedScreenSize > 0.0f)
+			{
+				int mip = 0;
+				while (mip < initialMip && MipSize(std::max(width, height), mip + 1) >= texture->m_requestedScreenSize)
+				{
+					++mip;
+				}
+				texture->m_wantedMip = mip;
+				texture->m_wantedScreenSize = texture->m_requestedScreenSize;
+				texture->m_lastRequestedFrame = m_frame;
+			}
+			else if (m_frame - texture->m_lastRequestedFrame > StreamingIdleFrames)
+			{
+				texture->m_wantedMip = initialMip;
+				texture->m_wantedScreenSize = 0.0f;
+			}
+			texture->m_requestedScreenSize = 0.0f;
+
+			if (texture->m_pendingMip >= 0 || texture->m_wantedMip < 0)
+			{
+				continue;
+			}
+			if (texture->m_wantedMip < texture->m_residentMip)
+			{
+				m_upgradeCandidates.push_back(texture);
+			}
+			else if (texture->m_wantedMip > texture->m_residentMip)
+			{
+				m_evictCandidates.push_back(texture);
+			}
+		}
+		m_streamedBytes = static_cast<size_t>(residentBytes);
+
+		// Largest on screen first, evicting the ones drawn longest ago
+		std::sort(m_upgradeCandidates.begin(), m_upgradeCandidates.end(), [](const auto& a, const auto& b)
+			{
+				return a->m_wantedScreenSize > b->m_wantedScreenSize;
+			});
+		std::sort(m_evictCandidates.begin(), m_evictCandidates.end(), [](const auto& a, const auto& b)
+			{
+				return a->m_lastRequestedFrame < b->m_lastRequestedFrame;
+			});
+
+		const int64_t budget = static_cast<int64_t>(m_streamingBudget);
+		size_t evictIndex = 0;
+		auto evictNext = [this, &evictIndex]()
+			{
+				if (evictIndex >= m_evictCandidates.size() || m_streamingRequests >= MaxStreamingRequests)
+				{
+					return false;
+				}
+				auto& texture = m_evictCandidates[evictIndex++];
+				RequestMip(texture, texture->m_wantedMip);
+				return true;
+			};
+
+		// A lowered budget is met before anything new comes in
+		while (residentBytes + m_pendingStreamBytes > budget && evictNext())
+		{
+		}
+
+		for (auto& texture : m_upgradeCandidates)
+		{
+			if (m_streamingRequests >= MaxStreamingRequests)
+			{
+				break;
+			}
+
+			// The wanted mip if it fits, otherwise the best one between it and the resident one that does
+			const int64_t currentBytes = MipChainBytes(texture->m_fullWidth, texture->m_fullHeight, texture->m_numChannels, texture->m_residentMip);
+			for (int mip = texture->m_wantedMip; mip < texture->m_residentMip; ++mip)
+			{
+				const int64_t cost = MipChainBytes(texture->m_fullWidth, texture->m_fullHeight, texture->m_numChannels, mip) - currentBytes;
+				while (residentBytes + m_pendingStreamBytes + cost > budget && evictNext())
+				{
+				}
+				if (residentBytes + m_pendingStreamBytes + cost <= budget)
+				{
+					RequestMip(texture, mip);
+					break;
+				}
+			}
+		}
+	}
+
+	void TextureManager::RequestMip(const std::shared_ptr<Texture>& texture, int mip)
+	{
+		DecodedImage request;
+		request.texture = texture;
+		request.path = texture->m_file;
+		request.mip = mip;
+		request.streamingRequest = true;
+		request.byteDelta =
+			MipChainBytes(texture->m_fullWidth, texture->m_fullHeight, texture->m_numChannels, mip) -
+			MipChainBytes(texture->m_fullWidth, texture->m_fullHeight, texture->m_numChannels, texture->m_residentMip);
+
+		texture->m_pendingMip = mip;
+		m_pendingStreamBytes += request.byteDelta;
+		++m_streamingRequests;
+		++m_pendingCount;
+
+		Engine::GetInstance().GetJobSystem().Run([this, request, file = texture->m_file]()
+			{
+				Decode(request, file);
+			}, &m_decodes);
+	}
+
+	unsigned int TextureManager::GetPlaceholderID()
+	{
+		// White, so materials that multiply with their texture look untextured until it arrives
+		if (!m_placeholder)
+		{
+			unsigned char white[4] = { 255, 255, 255, 255 };
+			m_placeholder = std::make_shared<Texture>(1, 1, 4, white);
+		}
+		return m_placeholder->GetID();
+	}
+
+	void TextureManager::CollectDecoded()
+	{
+		std::lock_guard<std::mutex> lock(m_decodedMutex);
+		for (auto& image : m_decoded)
+		{
+			m_uploads.push_back(std::move(image));
+		}
+		m_decoded.clear();
+	}
+
+	void TextureManager::Upload(DecodedImage& image)
+	{
+		--m_pendingCount;
+		auto texture = image.texture.lock();
+		if (image.streamingRequest)
+		{
+			--m_streamingRequests;
+			m_pendingStreamBytes -= image.byteDelta;
+			if (texture)
+			{
+				texture->m_pendingMip = -1;
+			}
+		}
+
+		if (!image.data)
+		{
+			std::cerr << "Failed to decode texture " << image.path << std::endl;
+			return;
+		}
+
+		// Skipped when nobody holds the texture anymore
+		if (texture)
+		{
+			PROFILE_SCOPE("TextureManager::Upload");
+			texture->Init(image.width, image.height, image.numChannels, image.data);
+			if (texture->m_streamed)
+			{
+				texture->m_fullWidth = image.fullWidth;
+				texture->m_fullHeight = image.fullHeight;
+				texture->m_residentMip = image.mip;
+			}
+		}
+		stbi_image_free(image.data);
+		image.data = nullptr;
+	}
 }
\ No newline at end of file
@@ -1,18 +1,30 @@
 #pragma once
 #include <glad/glad.h>
+#include "jobs/JobSystem.h"
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <cstdint>
 #include <unordered_map>
+#include <vector>
 
 namespace eng
 {
 	class Texture
 	{
 	public:
+		// Empty until Init, binds the placeholder it was given meanwhile
+		Texture() = default;
 		Texture(int width, int height, int numChannels, unsigned char* data);
 		~Texture();
+		// The placeholder while the texture is still loading
 		unsigned int GetID() const;
+		bool IsLoaded() const;
+		// Replaces the current image, if any
 		void Init(int width, int height, int numChannels, unsigned char* data);
+		// Largest on screen size in pixels the texture is drawn at, streamed textures pick their mip from it
+		void RequestScreenSize(float pixels);
 
 		static std::shared_ptr<Texture> Load(const std::string path);
 
@@ -21,14 +33,109 @@ namespace eng
 		int m_height = 0;
 		int m_numChannels = 0;
 		unsigned int m_textureID = 0;
+		unsigned int m_placeholderID = 0;
+
+		// Streaming state, maintained by TextureManager. Mips count down from the full image at 0.
+		bool m_streamed = false;
+		std::string m_file;
+		int m_fullWidth = 0;
+		int m_fullHeight = 0;
+		int m_residentMip = -1;
+		int m_pendingMip = -1;
+		int m_wantedMip = -1;
+		float m_requestedScreenSize = 0.0f;
+		float m_wantedScreenSize = 0.0f;
+		uint64_t m_lastRequestedFrame = 0;
+
+		friend class TextureManager;
 	};
 
 	class TextureManager
 	{
 	public:
+		static constexpr float DefaultUploadBudget = 2.0f;
+		static constexpr size_t DefaultStreamingBudget = 256 * 1024 * 1024;
+		// Largest side of the mip a streamed texture starts with
+		static constexpr int StreamingInitialSize = 64;
+		// Streamed textures not drawn for this many frames drop back to their initial mip when memory is needed
+		static constexpr uint64_t StreamingIdleFrames = 120;
+		static constexpr int MaxStreamingRequests = 4;
+
+		~TextureManager();
+
+		// Returns at once with a texture bound to a placeholder, the image is decoded on the job system
+		// and uploaded by a later Update. Null when the file does not exist.
 		std::shared_ptr<Texture> GetOrLoadTexture(const std::string& path);
 
+		// Uploads decoded images until the budget is used up, at least one per call. Needs the GL thread.
+		void Update();
+		// Milliseconds of uploads per Update
+		void SetUploadBudget(float milliseconds);
+		// Waits for every decode and uploads all of them, e.g. before a loading screen goes away
+		void FinishPendingLoads();
+		// Requested textures that are not uploaded yet
+		size_t GetPendingCount() const;
+
+		// Textures loaded while enabled start at a small mip. Higher mips are streamed in as their
+		// on screen size asks for them and dropped again to stay within the budget.
+		void SetStreamingEnabled(bool enabled);
+		bool IsStreamingEnabled() const;
+		// GPU memory for streamed textures in bytes, including their mip chains
+		void SetStreamingBudget(size_t bytes);
+		size_t GetStreamedBytes() const;
+
 	private:
-		std::unordered_map<std::string, std::shared_ptr<Texture>> m_textures;
+		struct DecodedImage
+		{
+			std::weak_ptr<Texture> texture;
+			std::string path;
+			int width = 0;
+			int height = 0;
+			int numChannels = 0;
+			unsigned char* data = nullptr;
+			// Streamed only: the mip it was reduced to, -1 asks for the initial one
+			int mip = 0;
+			int fullWidth = 0;
+			int fullHeight = 0;
+			// Change of the streamed bytes the upload brings, reserved while in flight
+			int64_t byteDelta = 0;
+			bool streamingRequest = false;
+		};
+
+		unsigned int GetPlaceholderID();
+		void Decode(DecodedImage request, const std::string& file);
+		void UpdateStreaming();
+		// Queues a decode of the texture reduced to the mip
+		void RequestMip(const std::shared_ptr<Texture>& texture, int mip);
+		// Moves decoded images from the workers over to the upload queue
+		void CollectDecoded();
+		void Upload(DecodedImage& image);
+
+	private:
+		// Weak like the material cache, a texture nobody uses anymore is freed and leaves the streaming budget
+		std::unordered_map<std::string, std::weak_ptr<Texture>> m_textures;
+		std::shared_ptr<Texture> m_placeholder;
+
+		// Filled by the decode jobs
+		std::mutex m_decodedMutex;
+		std::vector<DecodedImage> m_decoded;
+		JobCounter m_decodes;
+
+		// Main thread only
+		std::deque<DecodedImage> m_uploads;
+		size_t m_pendingCount = 0;
+		float m_uploadBudget = DefaultUploadBudget;
+
+		bool m_streamingEnabled = false;
+		size_t m_streamingBudget = DefaultStreamingBudget;
+		std::vector<std::weak_ptr<Texture>> m_streamed;
+		// Scratch lists of UpdateStreaming
+		std::vector<std::shared_ptr<Texture>> m_upgradeCandidates;
+		std::vector<std::shared_ptr<Texture>> m_evictCandidates;
+		size_t m_streamedBytes = 0;
+		// Bytes the requests in flight will add, negative when they mostly evict
+		int64_t m_pendingStreamBytes = 0;
+		int m_streamingRequests = 0;
+		uint64_t m_frame = 0;
 	};
 }
\ No newline at end of file
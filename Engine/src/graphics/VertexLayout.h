@@ -14,6 +14,8 @@ namespace eng
 		static constexpr int ColorIndex = 1;
 		static constexpr int UVIndex = 2;
 		static constexpr int NormalIndex = 3;
+		// mat4 per instance model matrix, takes locations 4 to 7
+		static constexpr int InstanceModelIndex = 4;
 	};
 
 	struct VertexLayout
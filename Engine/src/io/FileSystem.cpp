@@ -35,6 +35,11 @@ namespace eng
 
     std::filesystem::path FileSystem::GetAssetsFolder() const
     {
+        if (!m_assetsFolder.empty())
+        {
+            return m_assetsFolder;
+        }
+
 #if defined (ASSETS)
         auto path = std::filesystem::path(std::string(ASSETS));
         if (std::filesystem::exists(path))
@@ -45,6 +50,11 @@ namespace eng
         return std::filesystem::weakly_canonical(GetExecutableFolder() / "assets");
     }
 
+    void FileSystem::SetAssetsFolder(const std::filesystem::path& path)
+    {
+        m_assetsFolder = path.empty() ? path : std::filesystem::weakly_canonical(path);
+    }
+
     std::vector<char> FileSystem::LoadFile(const std::filesystem::path& path)
     {
         std::ifstream file(path, std::ios::binary | std::ios::ate);
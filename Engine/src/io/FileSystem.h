@@ -9,9 +9,14 @@ namespace eng
     public:
         std::filesystem::path GetExecutableFolder() const;
         std::filesystem::path GetAssetsFolder() const;
+        // Overrides the default assets folder lookup, an empty path restores it
+        void SetAssetsFolder(const std::filesystem::path& path);
 
         std::vector<char> LoadFile(const std::filesystem::path& path);
         std::vector<char> LoadAssetFile(const std::string& relativePath);
         std::string LoadAssetFileText(const std::string& relativePath);
+
+    private:
+        std::filesystem::path m_assetsFolder;
     };
 }
\ No newline at end of file
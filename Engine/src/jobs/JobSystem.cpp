@@ -0,0 +1,269 @@
+#include "jobs/JobSystem.h"
+#include "profiling/Profiler.h"
+#include <algorithm>
+#include <string>
+
+namespace eng
+{
+	namespace
+	{
+		// Set on worker threads, the queue a worker owns
+		thread_local const JobSystem* currentJobSystem = nullptr;
+		thread_local size_t currentWorkerIndex = 0;
+	}
+
+	bool JobCounter::IsDone() const
+	{
+		return m_count.load(std::memory_order_acquire) == 0;
+	}
+
+	JobSystem::~JobSystem()
+	{
+		Shutdown();
+	}
+
+	void JobSystem::Init(unsigned int workerCount)
+	{
+		if (!m_workers.empty())
+		{
+			return;
+		}
+
+		if (workerCount == 0)
+		{
+			const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+			workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+		}
+
+		m_stop = false;
+		for (unsigned int i = 0; i < workerCount; ++i)
+		{
+			m_queues.push_back(std::make_unique<WorkerQueue>());
+		}
+		for (unsigned int i = 0; i < workerCount; ++i)
+		{
+			m_workers.emplace_back(&JobSystem::WorkerLoop, this, static_cast<size_t>(i));
+		}
+	}
+
+	void JobSystem::Shutdown()
+	{
+		if (m_workers.empty())
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_stop = true;
+		}
+		m_wakeCondition.notify_all();
+
+		for (auto& worker : m_workers)
+		{
+			worker.join();
+		}
+		m_workers.clear();
+		m_queues.clear();
+	}
+
+	unsigned int JobSystem::GetWorkerCount() const
+	{
+		return static_cast<unsigned int>(m_workers.size());
+	}
+
+	void JobSystem::Run(Job job, JobCounter* counter, JobCounter* dependency)
+	{
+		if (counter)
+		{
+			counter->m_count.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		if (dependency)
+		{
+			std::lock_guard<std::mutex> lock(dependency->m_mutex);
+			if (dependency->m_count.load(std::memory_order_acquire) > 0)
+			{
+				dependency->m_continuations.emplace_back(std::move(job), counter);
+				return;
+			}
+		}
+
+		Enqueue({ std::move(job), counter });
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		while (!counter.IsDone())
+		{
+			if (!TryRunJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		// The last Finish may still hold the lock, the counter must not go away before it let go
+		std::lock_guard<std::mutex> lock(counter.m_mutex);
+	}
+
+	void JobSystem::ParallelFor(size_t count, size_t minBatchSize, const std::function<void(size_t begin, size_t end)>& function)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		minBatchSize = std::max<size_t>(minBatchSize, 1);
+		if (m_workers.empty() || count <= minBatchSize)
+		{
+			function(0, count);
+			return;
+		}
+
+		PROFILE_SCOPE("JobSystem::ParallelFor");
+
+		// A few batches per thread so stealing can even out uneven batches
+		const size_t maxBatches = (m_workers.size() + 1) * 4;
+		const size_t batchCount = std::min(maxBatches, (count + minBatchSize - 1) / minBatchSize);
+		const size_t batchSize = (count + batchCount - 1) / batchCount;
+
+		JobCounter counter;
+		for (size_t begin = batchSize; begin < count; begin += batchSize)
+		{
+			const size_t end = std::min(begin + batchSize, count);
+			Run([&function, begin, end]() { function(begin, end); }, &counter);
+		}
+
+		// The calling thread takes the first batch itself
+		function(0, std::min(batchSize, count));
+		Wait(counter);
+	}
+
+	void JobSystem::Enqueue(QueuedJob job)
+	{
+		if (m_workers.empty())
+		{
+			Execute(job);
+			return;
+		}
+
+		// Workers push to their own deque, other threads spread jobs round robin
+		const size_t queueIndex = currentJobSystem == this ?
+			currentWorkerIndex :
+			m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+		{
+			auto& queue = *m_queues[queueIndex];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs.push_back(std::move(job));
+		}
+
+		m_queuedJobs.fetch_add(1, std::memory_order_release);
+		{
+			// Pairs with the predicate check of a worker that is about to sleep
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+		}
+		m_wakeCondition.notify_one();
+	}
+
+	bool JobSystem::TryRunJob()
+	{
+		QueuedJob job;
+		if (!PopJob(job))
+		{
+			return false;
+		}
+		Execute(job);
+		return true;
+	}
+
+	bool JobSystem::PopJob(QueuedJob& job)
+	{
+		if (m_queuedJobs.load(std::memory_order_acquire) == 0)
+		{
+			return false;
+		}
+
+		const size_t queueCount = m_queues.size();
+		const bool isWorker = currentJobSystem == this;
+		const size_t first = isWorker ? currentWorkerIndex : m_nextQueue.load(std::memory_order_relaxed) % queueCount;
+
+		for (size_t i = 0; i < queueCount; ++i)
+		{
+			auto& queue = *m_queues[(first + i) % queueCount];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.jobs.empty())
+			{
+				continue;
+			}
+
+			// The owner takes its newest job while it is still hot in cache, thieves take the oldest
+			if (isWorker && i == 0)
+			{
+				job = std::move(queue.jobs.back());
+				queue.jobs.pop_back();
+			}
+			else
+			{
+				job = std::move(queue.jobs.front());
+				queue.jobs.pop_front();
+			}
+			m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+		return false;
+	}
+
+	void JobSystem::Execute(QueuedJob& job)
+	{
+		job.job();
+		if (job.counter)
+		{
+			Finish(*job.counter);
+		}
+	}
+
+	void JobSystem::Finish(JobCounter& counter)
+	{
+		std::vector<std::pair<Job, JobCounter*>> continuations;
+		{
+			std::lock_guard<std::mutex> lock(counter.m_mutex);
+			if (counter.m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				continuations.swap(counter.m_continuations);
+			}
+		}
+
+		for (auto& continuation : continuations)
+		{
+			Enqueue({ std::move(continuation.first), continuation.second });
+		}
+	}
+
+	void JobSystem::WorkerLoop(size_t index)
+	{
+		currentJobSystem = this;
+		currentWorkerIndex = index;
+		Profiler::GetInstance().SetThreadName("Worker " + std::to_string(index));
+
+		while (true)
+		{
+			if (TryRunJob())
+			{
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_wakeCondition.wait(lock, [this]()
+				{
+					return m_stop || m_queuedJobs.load(std::memory_order_acquire) > 0;
+				});
+
+			// Queued jobs are drained before the worker exits
+			if (m_stop && m_queuedJobs.load(std::memory_order_acquire) == 0)
+			{
+				return;
+			}
+		}
+	}
+}
\ No newline at end of file
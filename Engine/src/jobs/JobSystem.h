@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace eng
+{
+	using Job = std::function<void()>;
+
+	// Counts unfinished jobs. Jobs can be made to wait for a counter to reach zero.
+	// A counter must outlive the jobs it tracks and may be reused once it reached zero.
+	class JobCounter
+	{
+	public:
+		bool IsDone() const;
+
+	private:
+		friend class JobSystem;
+
+		std::atomic<int> m_count = 0;
+		std::mutex m_mutex;
+		// Jobs and their counters, queued once the count reaches zero
+		std::vector<std::pair<Job, JobCounter*>> m_continuations;
+	};
+
+	// Fixed set of worker threads, each with its own deque. A worker pops its newest job and
+	// steals the oldest job of another worker when it runs dry. Callable from any thread.
+	class JobSystem
+	{
+	public:
+		JobSystem() = default;
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator = (const JobSystem&) = delete;
+
+		// 0 uses one worker per hardware thread besides the main one
+		void Init(unsigned int workerCount = 0);
+		void Shutdown();
+
+		unsigned int GetWorkerCount() const;
+
+		// counter is incremented now and decremented when the job finished.
+		// With a dependency the job is only queued once the dependency reached zero.
+		void Run(Job job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+		// Runs queued jobs on the calling thread until the counter reaches zero.
+		// Wait on a counter before destroying it.
+		void Wait(JobCounter& counter);
+
+		// Calls function(begin, end) over [0, count) in batches of at least minBatchSize and waits for all of them.
+		// Without workers the whole range runs on the calling thread.
+		void ParallelFor(size_t count, size_t minBatchSize, const std::function<void(size_t begin, size_t end)>& function);
+
+	private:
+		struct QueuedJob
+		{
+			Job job;
+			JobCounter* counter = nullptr;
+		};
+
+		struct WorkerQueue
+		{
+			std::mutex mutex;
+			std::deque<QueuedJob> jobs;
+		};
+
+		void Enqueue(QueuedJob job);
+		bool TryRunJob();
+		bool PopJob(QueuedJob& job);
+		void Execute(QueuedJob& job);
+		void Finish(JobCounter& counter);
+		void WorkerLoop(size_t index);
+
+	private:
+		std::vector<std::thread> m_workers;
+		std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+		std::atomic<size_t> m_nextQueue = 0;
+
+		std::mutex m_sleepMutex;
+		std::condition_variable m_wakeCondition;
+		std::atomic<size_t> m_queuedJobs = 0;
+		std::atomic<bool> m_stop = false;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "memory/PoolAllocator.h"
+#include <algorithm>
+#include <new>
+
+namespace eng
+{
+	PoolAllocator::PoolAllocator(size_t blockSize, size_t alignment, size_t blocksPerChunk)
+		: m_alignment(std::max(alignment, alignof(FreeBlock))), m_blocksPerChunk(std::max<size_t>(blocksPerChunk, 1))
+	{
+		// Every block has to be able to hold the free list link and stay aligned
+		blockSize = std::max(blockSize, sizeof(FreeBlock));
+		m_blockSize = (blockSize + m_alignment - 1) / m_alignment * m_alignment;
+	}
+
+	PoolAllocator::~PoolAllocator()
+	{
+		for (auto chunk : m_chunks)
+		{
+			::operator delete(chunk, std::align_val_t(m_alignment));
+		}
+	}
+
+	void* PoolAllocator::Allocate()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_freeList)
+		{
+			AddChunk();
+		}
+
+		FreeBlock* block = m_freeList;
+		m_freeList = block->next;
+		++m_liveCount;
+		return block;
+	}
+
+	void PoolAllocator::Deallocate(void* ptr)
+	{
+		if (!ptr)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto block = static_cast<FreeBlock*>(ptr);
+		block->next = m_freeList;
+		m_freeList = block;
+		--m_liveCount;
+	}
+
+	size_t PoolAllocator::GetBlockSize() const
+	{
+		return m_blockSize;
+	}
+
+	size_t PoolAllocator::GetLiveCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_liveCount;
+	}
+
+	size_t PoolAllocator::GetChunkCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_chunks.size();
+	}
+
+	void PoolAllocator::AddChunk()
+	{
+		auto chunk = static_cast<char*>(::operator new(m_blockSize * m_blocksPerChunk, std::align_val_t(m_alignment)));
+		m_chunks.push_back(chunk);
+
+		// Linked back to front so blocks are handed out in address order
+		for (size_t i = m_blocksPerChunk; i > 0; --i)
+		{
+			auto block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * m_blockSize);
+			block->next = m_freeList;
+			m_freeList = block;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace eng
+{
+	// Fixed size blocks carved out of large chunks, so objects of one type end up next to each other.
+	// Freed blocks are reused before a new chunk is allocated. Thread safe.
+	class PoolAllocator
+	{
+	public:
+		PoolAllocator(size_t blockSize, size_t alignment, size_t blocksPerChunk = 256);
+		~PoolAllocator();
+
+		PoolAllocator(const PoolAllocator&) = delete;
+		PoolAllocator& operator = (const PoolAllocator&) = delete;
+
+		void* Allocate();
+		void Deallocate(void* ptr);
+
+		size_t GetBlockSize() const;
+		size_t GetLiveCount() const;
+		size_t GetChunkCount() const;
+
+	private:
+		struct FreeBlock
+		{
+			FreeBlock* next;
+		};
+
+		void AddChunk();
+
+	private:
+		size_t m_blockSize;
+		size_t m_alignment;
+		size_t m_blocksPerChunk;
+
+		mutable std::mutex m_mutex;
+		std::vector<void*> m_chunks;
+		FreeBlock* m_freeList = nullptr;
+		size_t m_liveCount = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "memory/SizeClassAllocator.h"
+#include <new>
+
+namespace eng
+{
+	SizeClassAllocator::SizeClassAllocator(size_t blocksPerChunk)
+		: m_blocksPerChunk(blocksPerChunk)
+	{
+	}
+
+	SizeClassAllocator::~SizeClassAllocator()
+	{
+		for (auto& pool : m_pools)
+		{
+			delete pool.load();
+		}
+	}
+
+	void* SizeClassAllocator::Allocate(size_t size)
+	{
+		if (size == 0 || size > MaxPooledSize)
+		{
+			return ::operator new(size);
+		}
+		return GetPool(size).Allocate();
+	}
+
+	void SizeClassAllocator::Deallocate(void* ptr, size_t size)
+	{
+		if (size == 0 || size > MaxPooledSize)
+		{
+			::operator delete(ptr);
+			return;
+		}
+		GetPool(size).Deallocate(ptr);
+	}
+
+	PoolAllocator& SizeClassAllocator::GetPool(size_t size)
+	{
+		const size_t index = (size + Granularity - 1) / Granularity - 1;
+		PoolAllocator* pool = m_pools[index].load(std::memory_order_acquire);
+		if (!pool)
+		{
+			// Racing threads both build a pool, the loser throws its one away
+			auto created = new PoolAllocator((index + 1) * Granularity, alignof(std::max_align_t), m_blocksPerChunk);
+			if (m_pools[index].compare_exchange_strong(pool, created, std::memory_order_acq_rel))
+			{
+				pool = created;
+			}
+			else
+			{
+				delete created;
+			}
+		}
+		return *pool;
+	}
+}
\ No newline at end of file
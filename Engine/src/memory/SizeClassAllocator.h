@@ -0,0 +1,35 @@
+#pragma once
+#include "memory/PoolAllocator.h"
+#include <atomic>
+#include <cstddef>
+
+namespace eng
+{
+	// Pools for objects of varying size, e.g. a class hierarchy. Sizes are rounded up to
+	// Granularity and each rounded size gets its own PoolAllocator. Larger sizes use the global heap.
+	class SizeClassAllocator
+	{
+	public:
+		static constexpr size_t Granularity = 16;
+		static constexpr size_t MaxPooledSize = 4096;
+
+		explicit SizeClassAllocator(size_t blocksPerChunk = 64);
+		~SizeClassAllocator();
+
+		SizeClassAllocator(const SizeClassAllocator&) = delete;
+		SizeClassAllocator& operator = (const SizeClassAllocator&) = delete;
+
+		void* Allocate(size_t size);
+		// size must be the one passed to Allocate
+		void Deallocate(void* ptr, size_t size);
+
+	private:
+		PoolAllocator& GetPool(size_t size);
+
+	private:
+		static constexpr size_t ClassCount = MaxPooledSize / Granularity;
+
+		size_t m_blocksPerChunk;
+		std::atomic<PoolAllocator*> m_pools[ClassCount] = {};
+	};
+}
\ No newline at end of file
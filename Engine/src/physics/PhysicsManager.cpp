@@ -1,6 +1,7 @@
 #include "PhysicsManager.h"
 #include "RigidBody.h"
 #include "physics/CollisionObject.h"
+#include "profiling/Profiler.h"
 #include <btBulletDynamicsCommon.h>
 #include <btBulletCollisionCommon.h>
 
@@ -27,9 +28,14 @@ namespace eng
 
 	void PhysicsManager::Update(float deltaTime)
 	{
+		PROFILE_SCOPE("PhysicsManager::Update");
+
 		const btScalar fixedTimeStep = 1.0f / 60.0f;
 		const int maxSubsteps = 4;
-		m_world->stepSimulation(deltaTime, maxSubsteps, fixedTimeStep);
+		{
+			PROFILE_SCOPE("PhysicsManager::StepSimulation");
+			m_world->stepSimulation(deltaTime, maxSubsteps, fixedTimeStep);
+		}
 
 		// process collisions
 		auto dispatcher = m_world->getDispatcher();
@@ -92,6 +98,25 @@ namespace eng
 		}
 	}
 
+	void PhysicsManager::RemoveRigidBodies(const std::vector<RigidBody*>& bodies)
+	{
+		if (!m_world)
+		{
+			return;
+		}
+
+		PROFILE_SCOPE("PhysicsManager::RemoveRigidBodies");
+		for (auto body : bodies)
+		{
+			auto rigidBody = body ? body->GetBody() : nullptr;
+			if (rigidBody && body->IsAddedToWorld())
+			{
+				m_world->removeRigidBody(rigidBody);
+				body->SetAddedToWorld(false);
+			}
+		}
+	}
+
 	btDiscreteDynamicsWorld* PhysicsManager::GetWorld()
 	{
 		return m_world.get();
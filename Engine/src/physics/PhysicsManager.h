@@ -1,5 +1,6 @@
 #pragma once
 #include <memory>
+#include <vector>
 
 class btBroadphaseInterface;
 class btDefaultCollisionConfiguration;
@@ -21,6 +22,8 @@ namespace eng
 
 		void AddRigidBody(RigidBody* body);
 		void RemoveRigidBody(RigidBody* body);
+		// Removes a batch of bodies in one pass, e.g. everything destroyed on the same frame
+		void RemoveRigidBodies(const std::vector<RigidBody*>& bodies);
 
 		btDiscreteDynamicsWorld* GetWorld();
 
@@ -131,4 +131,16 @@ namespace eng
 			btScalar(impulse.x), btScalar(impulse.y), btScalar(impulse.z)
 		));
 	}
+
+	void RigidBody::ResetMotion()
+	{
+		if (!m_body)
+		{
+			return;
+		}
+		m_body->setLinearVelocity(btVector3(0, 0, 0));
+		m_body->setAngularVelocity(btVector3(0, 0, 0));
+		m_body->clearForces();
+		m_body->activate(true);
+	}
 }
\ No newline at end of file
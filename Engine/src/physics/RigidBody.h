@@ -31,6 +31,8 @@ namespace eng
 		glm::quat GetRotation() const;
 
 		void ApplyImpulse(const glm::vec3& impulse);
+		// Stops the body, drops pending forces and wakes it up, e.g. before reusing it
+		void ResetMotion();
 
 	private:
 		std::unique_ptr<btRigidBody> m_body;
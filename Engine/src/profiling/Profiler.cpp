@@ -0,0 +1,176 @@
+#include "profiling/Profiler.h"
+#include <json/json.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+namespace eng
+{
+	namespace
+	{
+		const auto profilerEpoch = std::chrono::steady_clock::now();
+	}
+
+	std::atomic<bool> Profiler::s_capturing = false;
+
+	Profiler::Profiler() = default;
+
+	Profiler& Profiler::GetInstance()
+	{
+		static Profiler instance;
+		return instance;
+	}
+
+	bool Profiler::IsCapturing()
+	{
+		return s_capturing.load(std::memory_order_relaxed);
+	}
+
+	uint64_t Profiler::Now()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - profilerEpoch).count());
+	}
+
+	void Profiler::Record(const char* name, uint64_t start, uint64_t end)
+	{
+		// The buffer is only ever written by its own thread
+		auto& buffer = GetInstance().GetThreadBuffer();
+		const uint64_t written = buffer.written.load(std::memory_order_relaxed);
+		auto& event = buffer.events[written % EventsPerThread];
+		event.name = name;
+		event.start = start;
+		event.end = end;
+		buffer.written.store(written + 1, std::memory_order_release);
+	}
+
+	void Profiler::StartCapture(uint32_t frameCount, const std::filesystem::path& outputPath)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (auto& buffer : m_threadBuffers)
+		{
+			buffer->written.store(0, std::memory_order_relaxed);
+		}
+		m_frameCount = frameCount;
+		m_framesBegun = 0;
+		m_outputPath = outputPath;
+		m_captureStart = Now();
+		s_capturing.store(true, std::memory_order_release);
+	}
+
+	void Profiler::StopCapture()
+	{
+		if (IsCapturing())
+		{
+			FinishCapture();
+		}
+	}
+
+	void Profiler::BeginFrame()
+	{
+		if (!IsCapturing() || m_frameCount == 0)
+		{
+			return;
+		}
+
+		// The start of the frame after the last captured one
+		if (m_framesBegun++ == m_frameCount)
+		{
+			FinishCapture();
+		}
+	}
+
+	void Profiler::SetThreadName(const std::string& name)
+	{
+		auto& buffer = GetThreadBuffer();
+		std::lock_guard<std::mutex> lock(m_mutex);
+		buffer.name = name;
+	}
+
+	bool Profiler::WriteChromeTrace(const std::filesystem::path& path)
+	{
+		if (IsCapturing())
+		{
+			std::cerr << "Profiler: stop the capture before writing the trace" << std::endl;
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		auto events = nlohmann::json::array();
+		for (const auto& buffer : m_threadBuffers)
+		{
+			const std::string threadName = buffer->name.empty() ? "Thread " + std::to_string(buffer->threadId) : buffer->name;
+			events.push_back({
+				{ "name", "thread_name" },
+				{ "ph", "M" },
+				{ "pid", 0 },
+				{ "tid", buffer->threadId },
+				{ "args", { { "name", threadName } } }
+			});
+
+			const uint64_t written = buffer->written.load(std::memory_order_acquire);
+			const uint64_t first = written > EventsPerThread ? written - EventsPerThread : 0;
+			for (uint64_t i = first; i < written; ++i)
+			{
+				const auto& event = buffer->events[i % EventsPerThread];
+				if (event.start < m_captureStart)
+				{
+					continue;
+				}
+
+				// Chrome expects microseconds
+				events.push_back({
+					{ "name", event.name },
+					{ "ph", "X" },
+					{ "pid", 0 },
+					{ "tid", buffer->threadId },
+					{ "ts", static_cast<double>(event.start - m_captureStart) / 1000.0 },
+					{ "dur", static_cast<double>(event.end - event.start) / 1000.0 }
+				});
+			}
+		}
+
+		std::ofstream file(path);
+		if (!file.is_open())
+		{
+			std::cerr << "Profiler: failed to open " << path << std::endl;
+			return false;
+		}
+
+		nlohmann::json trace;
+		trace["traceEvents"] = std::move(events);
+		trace["displayTimeUnit"] = "ms";
+		file << trace.dump();
+		return true;
+	}
+
+	Profiler::ThreadBuffer& Profiler::GetThreadBuffer()
+	{
+		// Buffers are owned by the profiler so events survive the thread
+		thread_local ThreadBuffer* threadBuffer = nullptr;
+		if (!threadBuffer)
+		{
+			auto buffer = std::make_unique<ThreadBuffer>();
+			buffer->events.resize(EventsPerThread);
+			std::lock_guard<std::mutex> lock(m_mutex);
+			buffer->threadId = static_cast<uint32_t>(m_threadBuffers.size());
+			threadBuffer = buffer.get();
+			m_threadBuffers.push_back(std::move(buffer));
+		}
+		return *threadBuffer;
+	}
+
+	void Profiler::FinishCapture()
+	{
+		s_capturing.store(false, std::memory_order_release);
+		if (!m_outputPath.empty())
+		{
+			if (WriteChromeTrace(m_outputPath))
+			{
+				std::cout << "Profiler: trace written to " << m_outputPath << std::endl;
+			}
+			m_outputPath.clear();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Set ENG_PROFILING to 0 to compile the zones out entirely
+#if !defined (ENG_PROFILING)
+#define ENG_PROFILING 1
+#endif
+
+#define ENG_PROFILE_CONCAT_INNER(a, b) a##b
+#define ENG_PROFILE_CONCAT(a, b) ENG_PROFILE_CONCAT_INNER(a, b)
+
+#if ENG_PROFILING
+// Times the enclosing scope, name must be a string literal or otherwise outlive the capture
+#define PROFILE_SCOPE(name) ::eng::ProfileScope ENG_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+#endif
+
+namespace eng
+{
+	// Records scoped CPU zones into per-thread ring buffers while a capture is running.
+	// Outside a capture a zone costs one relaxed atomic load.
+	class Profiler
+	{
+	public:
+		// Oldest zones of a thread are overwritten once its buffer is full
+		static constexpr size_t EventsPerThread = 1 << 16;
+
+		struct Event
+		{
+			const char* name = nullptr;
+			uint64_t start = 0;
+			uint64_t end = 0;
+		};
+
+		static Profiler& GetInstance();
+
+		static bool IsCapturing();
+		// Nanoseconds since the profiler was created
+		static uint64_t Now();
+		static void Record(const char* name, uint64_t start, uint64_t end);
+
+		// Captures the next frameCount frames, 0 runs until StopCapture.
+		// A non-empty outputPath gets the Chrome trace written when the capture ends.
+		void StartCapture(uint32_t frameCount, const std::filesystem::path& outputPath = {});
+		void StopCapture();
+		// Called at the start of every frame, ends a frame limited capture
+		void BeginFrame();
+
+		// Names the calling thread in the exported trace
+		void SetThreadName(const std::string& name);
+
+		// chrome://tracing and Perfetto load this format
+		bool WriteChromeTrace(const std::filesystem::path& path);
+
+	private:
+		struct ThreadBuffer
+		{
+			std::vector<Event> events;
+			std::atomic<uint64_t> written = 0;
+			uint32_t threadId = 0;
+			std::string name;
+		};
+
+		Profiler();
+		Profiler(const Profiler&) = delete;
+		Profiler& operator = (const Profiler&) = delete;
+
+		ThreadBuffer& GetThreadBuffer();
+		void FinishCapture();
+
+	private:
+		static std::atomic<bool> s_capturing;
+
+		std::mutex m_mutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> m_threadBuffers;
+		uint32_t m_frameCount = 0;
+		uint32_t m_framesBegun = 0;
+		uint64_t m_captureStart = 0;
+		std::filesystem::path m_outputPath;
+	};
+
+	class ProfileScope
+	{
+	public:
+		explicit ProfileScope(const char* name)
+		{
+			if (Profiler::IsCapturing())
+			{
+				m_name = name;
+				m_start = Profiler::Now();
+			}
+		}
+
+		~ProfileScope()
+		{
+			if (m_name)
+			{
+				Profiler::Record(m_name, m_start, Profiler::Now());
+			}
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator = (const ProfileScope&) = delete;
+
+	private:
+		const char* m_name = nullptr;
+		uint64_t m_start = 0;
+	};
+}
\ No newline at end of file
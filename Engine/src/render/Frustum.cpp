@@ -0,0 +1,61 @@
+#include "render/Frustum.h"
+#include <glm/glm.hpp>
+
+namespace eng
+{
+	Frustum::Frustum(const glm::mat4& viewProjection)
+	{
+		auto row = [&viewProjection](int i)
+			{
+				return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+			};
+
+		const glm::vec4 r0 = row(0);
+		const glm::vec4 r1 = row(1);
+		const glm::vec4 r2 = row(2);
+		const glm::vec4 r3 = row(3);
+
+		m_planes[0] = r3 + r0; // left
+		m_planes[1] = r3 - r0; // right
+		m_planes[2] = r3 + r1; // bottom
+		m_planes[3] = r3 - r1; // top
+		m_planes[4] = r3 + r2; // near
+		m_planes[5] = r3 - r2; // far
+
+		for (auto& plane : m_planes)
+		{
+			float length = glm::length(glm::vec3(plane));
+			if (length > 0.0f)
+			{
+				plane /= length;
+			}
+		}
+	}
+
+	bool Frustum::IsBoxVisible(const BoundingBox& box, const glm::mat4& transform) const
+	{
+		// Transform the box into a world space box (center + half extents)
+		const glm::vec3 localCenter = (box.min + box.max) * 0.5f;
+		const glm::vec3 localExtents = (box.max - box.min) * 0.5f;
+
+		const glm::vec3 center = glm::vec3(transform * glm::vec4(localCenter, 1.0f));
+		const glm::mat3 absRotScale(
+			glm::abs(glm::vec3(transform[0])),
+			glm::abs(glm::vec3(transform[1])),
+			glm::abs(glm::vec3(transform[2])));
+		const glm::vec3 extents = absRotScale * localExtents;
+
+		for (const auto& plane : m_planes)
+		{
+			const glm::vec3 normal(plane);
+			float distance = glm::dot(normal, center) + plane.w;
+			float radius = glm::dot(glm::abs(normal), extents);
+			if (distance + radius < 0.0f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
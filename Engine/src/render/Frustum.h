@@ -0,0 +1,22 @@
+#pragma once
+#include "Common.h"
+#include <glm/vec4.hpp>
+#include <array>
+
+namespace eng
+{
+	class Frustum
+	{
+	public:
+		Frustum() = default;
+		// Extracts the six clip planes from a combined projection * view matrix
+		explicit Frustum(const glm::mat4& viewProjection);
+
+		// Tests the box after transforming it by the given model matrix
+		bool IsBoxVisible(const BoundingBox& box, const glm::mat4& transform) const;
+
+	private:
+		// xyz - normal pointing inside the frustum, w - distance
+		std::array<glm::vec4, 6> m_planes;
+	};
+}
@@ -0,0 +1,173 @@
+#include "render/LightClusters.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace eng
+{
+	void LightClusters::Build(const CameraData& cameraData, const std::vector<LightData>& lights)
+	{
+		const float nearPlane = std::max(cameraData.nearPlane, 0.0001f);
+		const float farPlane = std::max(cameraData.farPlane, nearPlane * 1.001f);
+		m_depthSliceScale = static_cast<float>(GridSizeZ) / std::log(farPlane / nearPlane);
+		m_depthSliceBias = -std::log(nearPlane) * m_depthSliceScale;
+
+		m_clusterRanges.assign(ClusterCount * 2, 0);
+		m_lightIndices.clear();
+		m_pointLights.clear();
+		m_lightBounds.clear();
+
+		// Count lights per cluster
+		for (const auto& light : lights)
+		{
+			if (light.type != LightType::Point || light.radius <= 0.0f)
+			{
+				continue;
+			}
+
+			const glm::vec3 viewPosition = glm::vec3(cameraData.viewMatrix * glm::vec4(light.position, 1.0f));
+			LightBounds bounds;
+			if (!ComputeBounds(cameraData, viewPosition, light.radius, bounds))
+			{
+				continue;
+			}
+
+			m_pointLights.push_back(glm::vec4(light.position, light.radius));
+			m_pointLights.push_back(glm::vec4(light.color, 0.0f));
+			m_lightBounds.push_back(bounds);
+
+			for (uint32_t z = bounds.minZ; z <= bounds.maxZ; ++z)
+			{
+				for (uint32_t y = bounds.minY; y <= bounds.maxY; ++y)
+				{
+					for (uint32_t x = bounds.minX; x <= bounds.maxX; ++x)
+					{
+						++m_clusterRanges[((z * GridSizeY + y) * GridSizeX + x) * 2 + 1];
+					}
+				}
+			}
+		}
+
+		// Prefix sum into offsets, counts are clamped once the index list is full
+		uint32_t offset = 0;
+		for (uint32_t cluster = 0; cluster < ClusterCount; ++cluster)
+		{
+			const uint32_t count = std::min(m_clusterRanges[cluster * 2 + 1], MaxLightIndices - offset);
+			m_clusterRanges[cluster * 2] = offset;
+			m_clusterRanges[cluster * 2 + 1] = 0;
+			offset += count;
+		}
+		m_lightIndices.resize(offset);
+
+		// Fill, the count is used as the write cursor
+		for (uint32_t lightIndex = 0; lightIndex < m_lightBounds.size(); ++lightIndex)
+		{
+			const auto& bounds = m_lightBounds[lightIndex];
+			for (uint32_t z = bounds.minZ; z <= bounds.maxZ; ++z)
+			{
+				for (uint32_t y = bounds.minY; y <= bounds.maxY; ++y)
+				{
+					for (uint32_t x = bounds.minX; x <= bounds.maxX; ++x)
+					{
+						const uint32_t cluster = (z * GridSizeY + y) * GridSizeX + x;
+						const uint32_t next = cluster + 1 < ClusterCount ? m_clusterRanges[(cluster + 1) * 2] : offset;
+						uint32_t& count = m_clusterRanges[cluster * 2 + 1];
+						const uint32_t position = m_clusterRanges[cluster * 2] + count;
+						if (position < next)
+						{
+							m_lightIndices[position] = lightIndex;
+							++count;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	bool LightClusters::ComputeBounds(const CameraData& cameraData, const glm::vec3& viewPosition, float radius, LightBounds& bounds) const
+	{
+		// View space looks down -z
+		const float nearPlane = cameraData.nearPlane;
+		const float farPlane = cameraData.farPlane;
+		float minDepth = -viewPosition.z - radius;
+		float maxDepth = -viewPosition.z + radius;
+		if (maxDepth < nearPlane || minDepth > farPlane)
+		{
+			return false;
+		}
+		minDepth = std::max(minDepth, nearPlane);
+		maxDepth = std::min(maxDepth, farPlane);
+
+		// Project the corners of the sphere's view space box, clamped to the near plane.
+		// x / depth is monotonic, so the corners bound the whole box on screen.
+		glm::vec2 ndcMin(1.0f);
+		glm::vec2 ndcMax(-1.0f);
+		for (int i = 0; i < 8; ++i)
+		{
+			const glm::vec4 corner(
+				viewPosition.x + ((i & 1) ? radius : -radius),
+				viewPosition.y + ((i & 2) ? radius : -radius),
+				(i & 4) ? -minDepth : -maxDepth,
+				1.0f);
+			const glm::vec4 clip = cameraData.projectionMatrix * corner;
+			const glm::vec2 ndc = glm::vec2(clip) / clip.w;
+			ndcMin = glm::min(ndcMin, ndc);
+			ndcMax = glm::max(ndcMax, ndc);
+		}
+
+		if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f)
+		{
+			return false;
+		}
+
+		auto toCell = [](float ndc, uint32_t size)
+			{
+				const float cell = (ndc * 0.5f + 0.5f) * static_cast<float>(size);
+				return static_cast<uint32_t>(glm::clamp(cell, 0.0f, static_cast<float>(size - 1)));
+			};
+
+		bounds.minX = toCell(ndcMin.x, GridSizeX);
+		bounds.maxX = toCell(ndcMax.x, GridSizeX);
+		bounds.minY = toCell(ndcMin.y, GridSizeY);
+		bounds.maxY = toCell(ndcMax.y, GridSizeY);
+		bounds.minZ = DepthToSlice(minDepth);
+		bounds.maxZ = DepthToSlice(maxDepth);
+		return true;
+	}
+
+	uint32_t LightClusters::DepthToSlice(float depth) const
+	{
+		const float slice = std::log(depth) * m_depthSliceScale + m_depthSliceBias;
+		return static_cast<uint32_t>(glm::clamp(slice, 0.0f, static_cast<float>(GridSizeZ - 1)));
+	}
+
+	const std::vector<uint32_t>& LightClusters::GetClusterRanges() const
+	{
+		return m_clusterRanges;
+	}
+
+	const std::vector<uint32_t>& LightClusters::GetLightIndices() const
+	{
+		return m_lightIndices;
+	}
+
+	const std::vector<glm::vec4>& LightClusters::GetPointLights() const
+	{
+		return m_pointLights;
+	}
+
+	uint32_t LightClusters::GetPointLightCount() const
+	{
+		return static_cast<uint32_t>(m_lightBounds.size());
+	}
+
+	float LightClusters::GetDepthSliceScale() const
+	{
+		return m_depthSliceScale;
+	}
+
+	float LightClusters::GetDepthSliceBias() const
+	{
+		return m_depthSliceBias;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+#include "Common.h"
+#include <vector>
+#include <cstdint>
+#include <glm/vec4.hpp>
+
+namespace eng
+{
+	// Splits the view frustum into a 3D grid and bins point lights into it on the CPU.
+	// The grid is uniform in screen space and exponential in view depth.
+	class LightClusters
+	{
+	public:
+		static constexpr uint32_t GridSizeX = 16;
+		static constexpr uint32_t GridSizeY = 9;
+		static constexpr uint32_t GridSizeZ = 24;
+		static constexpr uint32_t ClusterCount = GridSizeX * GridSizeY * GridSizeZ;
+		// Minimum texture buffer size guaranteed by GL 3.3, indices past it are dropped
+		static constexpr uint32_t MaxLightIndices = 65536;
+
+		// Only point lights are binned, other types are ignored
+		void Build(const CameraData& cameraData, const std::vector<LightData>& lights);
+
+		// Two values per cluster: offset into the light index list and light count
+		const std::vector<uint32_t>& GetClusterRanges() const;
+		const std::vector<uint32_t>& GetLightIndices() const;
+		// Two texels per light: world position and radius, color
+		const std::vector<glm::vec4>& GetPointLights() const;
+		uint32_t GetPointLightCount() const;
+
+		// slice = log(depth) * scale + bias
+		float GetDepthSliceScale() const;
+		float GetDepthSliceBias() const;
+
+	private:
+		struct LightBounds
+		{
+			uint32_t minX, maxX;
+			uint32_t minY, maxY;
+			uint32_t minZ, maxZ;
+		};
+
+		bool ComputeBounds(const CameraData& cameraData, const glm::vec3& viewPosition, float radius, LightBounds& bounds) const;
+		uint32_t DepthToSlice(float depth) const;
+
+	private:
+		std::vector<uint32_t> m_clusterRanges;
+		std::vector<uint32_t> m_lightIndices;
+		std::vector<glm::vec4> m_pointLights;
+		std::vector<LightBounds> m_lightBounds;
+		float m_depthSliceScale = 0.0f;
+		float m_depthSliceBias = 0.0f;
+	};
+}
\ No newline at end of file
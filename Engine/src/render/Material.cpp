@@ -7,9 +7,42 @@
 
 namespace eng
 {
+	uint32_t Material::nextId = 1;
+
+	Material::Material() : m_id(nextId++)
+	{
+	}
+
+	uint32_t Material::GetId() const
+	{
+		return m_id;
+	}
+
 	void Material::SetShaderProgram(const std::shared_ptr<ShaderProgram>& shaderProgram)
 	{
 		m_shaderProgram = shaderProgram;
+		for (size_t i = 0; i < m_params.size(); ++i)
+		{
+			ResolveLocations(m_params[i], m_paramNames[i]);
+		}
+	}
+
+	std::shared_ptr<Material> Material::CreateInstance(const std::shared_ptr<Material>& parent)
+	{
+		if (!parent)
+		{
+			return nullptr;
+		}
+
+		auto result = std::make_shared<Material>();
+		result->m_parent = parent;
+		result->m_shaderProgram = parent->m_shaderProgram;
+		return result;
+	}
+
+	Material* Material::GetParent()
+	{
+		return m_parent.get();
 	}
 
 	ShaderProgram* Material::GetShaderProgram()
@@ -19,22 +52,64 @@ namespace eng
 
 	void Material::SetParam(const std::string& name, float value)
 	{
-		m_floatParams[name] = value;
+		auto& param = FindOrAddParam(name, ParamType::Float);
+		param.value[0] = value;
 	}
 
 	void Material::SetParam(const std::string& name, float v0, float v1)
 	{
-		m_float2Params[name] = { v0, v1 };
+		auto& param = FindOrAddParam(name, ParamType::Float2);
+		param.value[0] = v0;
+		param.value[1] = v1;
 	}
 
 	void Material::SetParam(const std::string& name, const glm::vec3& value)
 	{
-		m_float3Params[name] = value;
+		auto& param = FindOrAddParam(name, ParamType::Float3);
+		param.value[0] = value.x;
+		param.value[1] = value.y;
+		param.value[2] = value.z;
 	}
 
 	void Material::SetParam(const std::string& name, const std::shared_ptr<Texture>& texture)
 	{
-		m_textures[name] = texture;
+		auto& param = FindOrAddParam(name, ParamType::Texture);
+		param.texture = texture;
+	}
+
+	Material::Param& Material::FindOrAddParam(const std::string& name, ParamType type)
+	{
+		for (size_t i = 0; i < m_paramNames.size(); ++i)
+		{
+			if (m_paramNames[i] == name)
+			{
+				m_params[i].type = type;
+				return m_params[i];
+			}
+		}
+
+		m_paramNames.push_back(name);
+		m_params.emplace_back();
+		auto& param = m_params.back();
+		param.type = type;
+		ResolveLocations(param, name);
+		return param;
+	}
+
+	void Material::ResolveLocations(Param& param, const std::string& name)
+	{
+		param.location = -1;
+		param.instancedLocation = -1;
+		if (!m_shaderProgram)
+		{
+			return;
+		}
+
+		param.location = m_shaderProgram->GetUniformLocation(name);
+		if (auto instanced = m_shaderProgram->GetInstancedVariant())
+		{
+			param.instancedLocation = instanced->GetUniformLocation(name);
+		}
 	}
 
 	void Material::Bind()
@@ -45,25 +120,90 @@ namespace eng
 		}
 
 		m_shaderProgram->Bind();
+		BindParams();
+	}
 
-		for (auto& param : m_floatParams)
+	void Material::BindParams()
+	{
+		BindParams(m_shaderProgram.get());
+	}
+
+	void Material::BindParams(ShaderProgram* shaderProgram)
+	{
+		if (!shaderProgram)
 		{
-			m_shaderProgram->SetUniform(param.first, param.second);
+			return;
 		}
 
-		for (auto& param : m_float2Params)
+		shaderProgram->ResetTextureUnits();
+		ApplyParams(shaderProgram);
+	}
+
+	void Material::RequestTextureScreenSize(float pixels)
+	{
+		if (m_parent)
 		{
-			m_shaderProgram->SetUniform(param.first, param.second.first, param.second.second);
+			m_parent->RequestTextureScreenSize(pixels);
 		}
 
-		for (auto& param : m_float3Params)
+		for (auto& param : m_params)
 		{
-			m_shaderProgram->SetUniform(param.first, param.second);
+			if (param.type == ParamType::Texture && param.texture)
+			{
+				param.texture->RequestScreenSize(pixels);
+			}
 		}
+	}
 
-		for (auto& param : m_textures)
+	void Material::ApplyParams(ShaderProgram* shaderProgram)
+	{
+		if (m_parent)
 		{
-			m_shaderProgram->SetTexture(param.first, param.second.get());
+			m_parent->ApplyParams(shaderProgram);
+		}
+
+		const bool isOwnProgram = shaderProgram == m_shaderProgram.get();
+		const bool isInstancedVariant = !isOwnProgram && m_shaderProgram && shaderProgram == m_shaderProgram->GetInstancedVariant();
+
+		for (size_t i = 0; i < m_params.size(); ++i)
+		{
+			const auto& param = m_params[i];
+
+			int location;
+			if (isOwnProgram)
+			{
+				location = param.location;
+			}
+			else if (isInstancedVariant)
+			{
+				location = param.instancedLocation;
+			}
+			else
+			{
+				// Unknown program, resolve by name
+				location = shaderProgram->GetUniformLocation(m_paramNames[i]);
+			}
+
+			if (location < 0)
+			{
+				continue;
+			}
+
+			switch (param.type)
+			{
+			case ParamType::Float:
+				shaderProgram->SetUniform(location, param.value[0]);
+				break;
+			case ParamType::Float2:
+				shaderProgram->SetUniform(location, param.value[0], param.value[1]);
+				break;
+			case ParamType::Float3:
+				shaderProgram->SetUniform(location, glm::vec3(param.value[0], param.value[1], param.value[2]));
+				break;
+			case ParamType::Texture:
+				shaderProgram->SetTexture(location, param.texture.get());
+				break;
+			}
 		}
 	}
 
@@ -89,9 +229,10 @@ namespace eng
 			auto vertexSrc = fs.LoadAssetFileText(vertexPath);
 			auto fragmentSrc = fs.LoadAssetFileText(fragmentPath);
 
+			// Materials with the same shader sources share one program
 			auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
-			auto shaderProgram = graphicsAPI.CreateShaderProgram(vertexSrc, fragmentSrc);
-			
+			auto shaderProgram = graphicsAPI.GetOrCreateShaderProgram(vertexSrc, fragmentSrc, shaderObj.value("instancing", false));
+
 			if (!shaderProgram)
 			{
 				return nullptr;
@@ -147,7 +288,7 @@ namespace eng
 				{
 					std::string name = p.value("name", "");
 					std::string texPath = p.value("path", "");
-					auto texture = Texture::Load(texPath);
+					auto texture = Engine::GetInstance().GetTextureManager().GetOrLoadTexture(texPath);
 
 					result->SetParam(name, texture);
 				}
@@ -156,4 +297,23 @@ namespace eng
 
 		return result;
 	}
+
+	std::shared_ptr<Material> MaterialManager::GetOrLoadMaterial(const std::string& path)
+	{
+		auto it = m_materials.find(path);
+		if (it != m_materials.end())
+		{
+			if (auto material = it->second.lock())
+			{
+				return material;
+			}
+		}
+
+		auto material = Material::Load(path);
+		if (material)
+		{
+			m_materials[path] = material;
+		}
+		return material;
+	}
 }
\ No newline at end of file
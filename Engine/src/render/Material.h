@@ -1,7 +1,9 @@
 #pragma once
 #include <memory>
-#include <unordered_map>
+#include <cstdint>
+#include <vector>
 #include <string>
+#include <unordered_map>
 #include <glm/vec3.hpp>
 
 namespace eng
@@ -12,6 +14,9 @@ namespace eng
 	class Material
 	{
 	public:
+		Material();
+
+		uint32_t GetId() const;
 		void SetShaderProgram(const std::shared_ptr<ShaderProgram>& shaderProgram);
 		ShaderProgram* GetShaderProgram();
 		void SetParam(const std::string& name, float value);
@@ -19,14 +24,63 @@ namespace eng
 		void SetParam(const std::string& name, const glm::vec3& value);
 		void SetParam(const std::string& name, const std::shared_ptr<Texture>& texture);
 		void Bind();
+		// Uploads parameters only, expects the shader program to be bound already
+		void BindParams();
+		// Same, but into another program with the same parameters, e.g. the instanced variant
+		void BindParams(ShaderProgram* shaderProgram);
+		// Passes the on screen size of a draw on to every texture of the material, see Texture::RequestScreenSize
+		void RequestTextureScreenSize(float pixels);
 
+		// Uncached, use MaterialManager to share materials loaded from the same file
 		static std::shared_ptr<Material> Load(const std::string& path);
+		// Shares the program and parameters of the parent and only stores what is set on it,
+		// for per object overrides of a shared material
+		static std::shared_ptr<Material> CreateInstance(const std::shared_ptr<Material>& parent);
+		Material* GetParent();
+
+	private:
+		enum class ParamType : uint8_t
+		{
+			Float,
+			Float2,
+			Float3,
+			Texture
+		};
+
+		// Locations are resolved against the program and its instanced variant when set
+		struct Param
+		{
+			ParamType type = ParamType::Float;
+			int location = -1;
+			int instancedLocation = -1;
+			float value[3] = { 0.0f, 0.0f, 0.0f };
+			std::shared_ptr<Texture> texture;
+		};
+
+		Param& FindOrAddParam(const std::string& name, ParamType type);
+		void ResolveLocations(Param& param, const std::string& name);
+		// Parent parameters first, so the ones set on an instance win
+		void ApplyParams(ShaderProgram* shaderProgram);
 
 	private:
+		static uint32_t nextId;
+
+		uint32_t m_id = 0;
+		std::shared_ptr<Material> m_parent;
 		std::shared_ptr<ShaderProgram> m_shaderProgram;
-		std::unordered_map<std::string, float> m_floatParams;
-		std::unordered_map<std::string, std::pair<float, float>> m_float2Params;
-		std::unordered_map<std::string, glm::vec3> m_float3Params;
-		std::unordered_map<std::string, std::shared_ptr<Texture>> m_textures;
+		std::vector<Param> m_params;
+		// Parallel to m_params, only touched when setting or resolving
+		std::vector<std::string> m_paramNames;
+	};
+
+	class MaterialManager
+	{
+	public:
+		// Every caller asking for the same file gets the same material while any of them still holds it
+		std::shared_ptr<Material> GetOrLoadMaterial(const std::string& path);
+
+	private:
+		// Weak, a material and its program go away with the last object using them
+		std::unordered_map<std::string, std::weak_ptr<Material>> m_materials;
 	};
 }
\ No newline at end of file
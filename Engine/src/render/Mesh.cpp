@@ -1,10 +1,16 @@
 ﻿#include "render/Mesh.h"
 #include "graphics/GraphicsAPI.h"
 #include "Engine.h"
+#include <glm/common.hpp>
+#include <algorithm>
+#include <limits>
 
 namespace eng
 {
+	uint32_t Mesh::nextId = 1;
+
 	Mesh::Mesh(const VertexLayout& layout, const std::vector<float>& vertices, const std::vector<uint32_t>& indices)
+		: m_id(nextId++)
 	{
 		m_vertexLayout = layout;
 
@@ -12,72 +18,100 @@ namespace eng
 
 		m_VBO =  graphicsAPI.CreateVertexBuffer(vertices);
 		m_EBO =  graphicsAPI.CreateIndexBuffer(indices);
-
-		glGenVertexArrays(1, &m_VAO);
-		glBindVertexArray(m_VAO);
-
-		glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-
-		for (auto& element : m_vertexLayout.elements)
-		{
-			glVertexAttribPointer(element.index, element.size, element.type, GL_FALSE, m_vertexLayout.stride, (void*)(uintptr_t)element.offset);
-			glEnableVertexAttribArray(element.index);
-		}
-
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-
-		glBindVertexArray(0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		m_VAO = graphicsAPI.CreateVertexArray(m_vertexLayout, m_VBO, m_EBO);
 
 		m_vertexCount = (vertices.size() * sizeof(float)) / m_vertexLayout.stride;
 		m_indexCount = indices.size();
+
+		ComputeBounds(vertices);
 	}
 
 	Mesh::Mesh(const VertexLayout& layout, const std::vector<float>& vertices)
+		: m_id(nextId++)
 	{
 		m_vertexLayout = layout;
 
 		auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
 
 		m_VBO = graphicsAPI.CreateVertexBuffer(vertices);
+		m_VAO = graphicsAPI.CreateVertexArray(m_vertexLayout, m_VBO, 0);
 
-		glGenVertexArrays(1, &m_VAO);
-		glBindVertexArray(m_VAO);
+		m_vertexCount = (vertices.size() * sizeof(float)) / m_vertexLayout.stride;
+
+		ComputeBounds(vertices);
+	}
+
+	void Mesh::Bind()
+	{
+		Engine::GetInstance().GetGraphicsAPI().BindVertexArray(m_VAO);
+	}
+
+	void Mesh::Unbind()
+	{
+		Engine::GetInstance().GetGraphicsAPI().BindVertexArray(0);
+	}
 
-		glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+	void Mesh::Draw()
+	{
+		const bool indexed = IsIndexed();
+		Engine::GetInstance().GetGraphicsAPI().Draw(indexed ? m_indexCount : m_vertexCount, indexed);
+	}
 
-		for (auto& element : m_vertexLayout.elements)
+	void Mesh::SetupInstancing(unsigned int instanceBuffer)
+	{
+		if (m_instanceBuffer == instanceBuffer)
 		{
-			glVertexAttribPointer(element.index, element.size, element.type, GL_FALSE, m_vertexLayout.stride, (void*)(uintptr_t)element.offset);
-			glEnableVertexAttribArray(element.index);
+			return;
 		}
 
-		glBindVertexArray(0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		Engine::GetInstance().GetGraphicsAPI().SetInstanceAttributes(instanceBuffer);
 
-		m_vertexCount = (vertices.size() * sizeof(float)) / m_vertexLayout.stride;
+		m_instanceBuffer = instanceBuffer;
 	}
 
-	void Mesh::Bind()
+	void Mesh::DrawInstanced(size_t instanceCount)
 	{
-		glBindVertexArray(m_VAO);
+		const bool indexed = IsIndexed();
+		Engine::GetInstance().GetGraphicsAPI().DrawInstanced(indexed ? m_indexCount : m_vertexCount, indexed, instanceCount);
 	}
 
-	void Mesh::Unbind()
+	bool Mesh::IsIndexed() const
 	{
-		glBindVertexArray(0);
+		return m_indexCount > 0;
 	}
 
-	void Mesh::Draw()
+	uint32_t Mesh::GetId() const
 	{
-		if (m_indexCount > 0)
+		return m_id;
+	}
+
+	const BoundingBox& Mesh::GetBounds() const
+	{
+		return m_bounds;
+	}
+
+	void Mesh::ComputeBounds(const std::vector<float>& vertices)
+	{
+		auto it = std::find_if(m_vertexLayout.elements.begin(), m_vertexLayout.elements.end(),
+			[](const VertexElement& el) { return el.index == VertexElement::PositionIndex; });
+
+		if (it == m_vertexLayout.elements.end() || m_vertexCount == 0)
 		{
-			glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_indexCount), GL_UNSIGNED_INT, 0);
+			return;
 		}
-		else
+
+		const size_t strideInFloats = m_vertexLayout.stride / sizeof(float);
+		const size_t offsetInFloats = it->offset / sizeof(float);
+
+		m_bounds.min = glm::vec3(std::numeric_limits<float>::max());
+		m_bounds.max = glm::vec3(std::numeric_limits<float>::lowest());
+
+		for (size_t i = 0; i < m_vertexCount; ++i)
 		{
-			glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_indexCount));
+			const float* pos = &vertices[i * strideInFloats + offsetInFloats];
+			const glm::vec3 p(pos[0], pos[1], pos[2]);
+			m_bounds.min = glm::min(m_bounds.min, p);
+			m_bounds.max = glm::max(m_bounds.max, p);
 		}
 	}
 
@@ -1,6 +1,7 @@
 #pragma once
 #include <glad/glad.h>
 #include <graphics/VertexLayout.h>
+#include "Common.h"
 #include <glm/vec3.hpp>
 #include <memory>
 #include <string>
@@ -18,16 +19,32 @@ namespace eng
 		void Bind();
 		void Unbind();
 		void Draw();
+		// Attaches the per instance model matrix attributes of the bound VAO to the given buffer
+		void SetupInstancing(unsigned int instanceBuffer);
+		void DrawInstanced(size_t instanceCount);
+		bool IsIndexed() const;
+
+		uint32_t GetId() const;
+
+		const BoundingBox& GetBounds() const;
 
 		static std::shared_ptr<Mesh> CreateBox(const glm::vec3& extents = glm::vec3(1.0f));
 		static std::shared_ptr<Mesh> CreateSphere(float radius, int sectors, int stacks);
 
 	private:
+		static uint32_t nextId;
+
+		void ComputeBounds(const std::vector<float>& vertices);
+
+	private:
+		uint32_t m_id = 0;
 		VertexLayout m_vertexLayout;
+		BoundingBox m_bounds;
 
 		unsigned int m_VBO = 0;
 		unsigned int m_EBO = 0;
 		unsigned int m_VAO = 0;
+		unsigned int m_instanceBuffer = 0;
 
 		size_t m_vertexCount = 0;
 		size_t m_indexCount = 0;
@@ -1,39 +1,328 @@
 #include "render/RenderQueue.h"
 #include "render/Mesh.h"
 #include "render/Material.h"
+#include "render/Frustum.h"
 #include "graphics/GraphicsAPI.h"
 #include "graphics/ShaderProgram.h"
+#include "profiling/Profiler.h"
+#include "Engine.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstring>
 
 namespace eng
 {
+	// Sort key layout, most significant first
+	static constexpr int ShaderProgramBits = 12;
+	static constexpr int MaterialBits = 16;
+	static constexpr int MeshBits = 16;
+	static constexpr int DepthBits = 20;
+
+	static constexpr int DepthShift = 0;
+	static constexpr int MeshShift = DepthShift + DepthBits;
+	static constexpr int MaterialShift = MeshShift + MeshBits;
+	static constexpr int ShaderProgramShift = MaterialShift + MaterialBits;
+
+	static uint64_t MakeKeyField(uint64_t value, int bits, int shift)
+	{
+		return (value & ((1ull << bits) - 1)) << shift;
+	}
+
+	static uint64_t QuantizeDepth(float depth)
+	{
+		// The bit pattern of a non-negative float grows monotonically with its value,
+		// so the upper bits give a front to back order without knowing the depth range
+		if (!(depth > 0.0f))
+		{
+			depth = 0.0f;
+		}
+		uint32_t bits = 0;
+		std::memcpy(&bits, &depth, sizeof(bits));
+		return bits >> (32 - DepthBits - 1);
+	}
+
+	// Pixels the largest side of the mesh bounds covers, the UVs are assumed to span the texture once
+	static float EstimateScreenSize(const RenderCommand& command, const CameraData& cameraData)
+	{
+		const auto& bounds = command.mesh->GetBounds();
+		const glm::vec3 extents = bounds.max - bounds.min;
+		const glm::mat4& model = command.modelMatrix;
+		const float size = std::max({
+			extents.x * glm::length(glm::vec3(model[0])),
+			extents.y * glm::length(glm::vec3(model[1])),
+			extents.z * glm::length(glm::vec3(model[2])) });
+
+		const glm::vec3 center = glm::vec3(model * glm::vec4((bounds.min + bounds.max) * 0.5f, 1.0f));
+		const float distance = std::max(glm::length(center - cameraData.position), cameraData.nearPlane);
+
+		// projection[1][1] is cot(fov / 2), the viewport spans 2 / projection[1][1] units at distance 1
+		return size * cameraData.projectionMatrix[1][1] / distance * cameraData.viewportHeight * 0.5f;
+	}
+
 	void RenderQueue::Submit(const RenderCommand& command)
 	{
+		std::lock_guard<std::mutex> lock(m_submitMutex);
 		m_commands.push_back(command);
 	}
 
-	void RenderQueue::Draw(GraphicsAPI& graphicsAPI, const CameraData& cameraData, const std::vector<LightData>& lights)
+	void RenderQueue::Submit(const std::vector<RenderCommand>& commands)
 	{
-		for (auto& command : m_commands)
+		std::lock_guard<std::mutex> lock(m_submitMutex);
+		m_commands.insert(m_commands.end(), commands.begin(), commands.end());
+	}
+
+	void RenderQueue::Draw(GraphicsAPI& graphicsAPI, const CameraData& cameraData)
+	{
+		PROFILE_SCOPE("RenderQueue::Draw");
+
+		{
+			PROFILE_SCOPE("RenderQueue::Cull");
+			Cull(cameraData);
+		}
 		{
-			graphicsAPI.BindMaterial(command.material);
-			auto shaderProgram = command.material->GetShaderProgram();
-			shaderProgram->SetUniform("uModel", command.modelMatrix);
-			shaderProgram->SetUniform("uView", cameraData.viewMatrix);
-			shaderProgram->SetUniform("uProjection", cameraData.projectionMatrix);
-			shaderProgram->SetUniform("uCameraPos", cameraData.position);
+			PROFILE_SCOPE("RenderQueue::Sort");
+			Sort(cameraData);
+		}
+
+		ShaderProgram* currentShaderProgram = nullptr;
+		Material* currentMaterial = nullptr;
+		Mesh* currentMesh = nullptr;
+		int modelLocation = -1;
 
-			if (!lights.empty())
+		auto bindShaderProgram = [&](ShaderProgram* shaderProgram)
 			{
-				auto& light = lights[0];
-				shaderProgram->SetUniform("uLight.color", light.color);
-				shaderProgram->SetUniform("uLight.direction", glm::normalize(-light.position));
+				if (shaderProgram == currentShaderProgram)
+				{
+					return;
+				}
+
+				graphicsAPI.BindShaderProgram(shaderProgram);
+				currentShaderProgram = shaderProgram;
+				modelLocation = shaderProgram->GetUniformLocation("uModel");
+				currentMaterial = nullptr;
+				++m_stats.shaderProgramBinds;
+			};
+
+		auto bindMaterial = [&](Material* material)
+			{
+				if (material == currentMaterial)
+				{
+					return;
+				}
+
+				material->BindParams(currentShaderProgram);
+				currentMaterial = material;
+				++m_stats.materialBinds;
+			};
+
+		auto bindMesh = [&](Mesh* mesh)
+			{
+				if (mesh == currentMesh)
+				{
+					return;
+				}
+
+				graphicsAPI.BindMesh(mesh);
+				currentMesh = mesh;
+				++m_stats.meshBinds;
+			};
+
+		graphicsAPI.BeginGpuPass("RenderQueue::Draw");
+
+		// Screen sizes are only read by texture streaming, the default path skips them
+		const bool reportScreenSizes = cameraData.viewportHeight > 0.0f &&
+			Engine::GetInstance().GetTextureManager().IsStreamingEnabled();
+
+		const size_t count = m_visibleCommands.size();
+		for (size_t i = 0; i < count;)
+		{
+			auto command = m_visibleCommands[i];
+			auto shaderProgram = command->material->GetShaderProgram();
+
+			// Sorting puts commands with the same material and mesh next to each other
+			size_t runEnd = i + 1;
+			while (runEnd < count &&
+				m_visibleCommands[runEnd]->material == command->material &&
+				m_visibleCommands[runEnd]->mesh == command->mesh)
+			{
+				++runEnd;
+			}
+
+			const size_t runLength = runEnd - i;
+			auto instancedShaderProgram = shaderProgram->GetInstancedVariant();
+
+			// Feedback for texture streaming, the closest draw of the run decides
+			if (reportScreenSizes)
+			{
+				float screenSize = 0.0f;
+				for (size_t j = i; j < runEnd; ++j)
+				{
+					screenSize = std::max(screenSize, EstimateScreenSize(*m_visibleCommands[j], cameraData));
+				}
+				command->material->RequestTextureScreenSize(screenSize);
+			}
+
+			if (instancedShaderProgram && m_minInstanceBatchSize > 0 && runLength >= m_minInstanceBatchSize && command->mesh->IsIndexed())
+			{
+				if (m_instanceBuffer == 0)
+				{
+					m_instanceBuffer = graphicsAPI.CreateInstanceBuffer();
+				}
+
+				m_instanceData.clear();
+				for (size_t j = i; j < runEnd; ++j)
+				{
+					m_instanceData.push_back(m_visibleCommands[j]->modelMatrix);
+				}
+				graphicsAPI.UpdateInstanceBuffer(m_instanceBuffer, m_instanceData);
+
+				bindShaderProgram(instancedShaderProgram);
+				bindMaterial(command->material);
+				bindMesh(command->mesh);
+				command->mesh->SetupInstancing(m_instanceBuffer);
+
+				graphicsAPI.DrawMeshInstanced(command->mesh, runLength);
+				++m_stats.instancedDrawCalls;
+				m_stats.instancedCommands += runLength;
+				i = runEnd;
+				continue;
+			}
+
+			for (; i < runEnd; ++i)
+			{
+				command = m_visibleCommands[i];
+
+				bindShaderProgram(shaderProgram);
+				bindMaterial(command->material);
+				shaderProgram->SetUniform(modelLocation, command->modelMatrix);
+				bindMesh(command->mesh);
+
+				graphicsAPI.DrawMesh(command->mesh);
+				++m_stats.drawCalls;
 			}
+		}
 
-			graphicsAPI.BindMesh(command.mesh);
-			graphicsAPI.DrawMesh(command.mesh);
-			graphicsAPI.UnbindMesh(command.mesh);
+		if (currentMesh)
+		{
+			graphicsAPI.UnbindMesh(currentMesh);
 		}
 
+		graphicsAPI.EndGpuPass();
+
+		m_visibleCommands.clear();
 		m_commands.clear();
 	}
-}
\ No newline at end of file
+
+	void RenderQueue::SetMinInstanceBatchSize(size_t size)
+	{
+		m_minInstanceBatchSize = size;
+	}
+
+	size_t RenderQueue::GetMinInstanceBatchSize() const
+	{
+		return m_minInstanceBatchSize;
+	}
+
+	void RenderQueue::SetFrustumCullingEnabled(bool enabled)
+	{
+		m_frustumCullingEnabled = enabled;
+	}
+
+	bool RenderQueue::IsFrustumCullingEnabled() const
+	{
+		return m_frustumCullingEnabled;
+	}
+
+	const RenderStats& RenderQueue::GetStats() const
+	{
+		return m_stats;
+	}
+
+	void RenderQueue::Cull(const CameraData& cameraData)
+	{
+		m_stats = RenderStats();
+		m_stats.submitted = m_commands.size();
+
+		m_visibleCommands.clear();
+		m_visibleCommands.reserve(m_commands.size());
+
+		const Frustum frustum(cameraData.projectionMatrix * cameraData.viewMatrix);
+
+		for (auto& command : m_commands)
+		{
+			if (!command.material || !command.mesh || !command.material->GetShaderProgram())
+			{
+				continue;
+			}
+
+			if (m_frustumCullingEnabled && !frustum.IsBoxVisible(command.mesh->GetBounds(), command.modelMatrix))
+			{
+				++m_stats.culled;
+				continue;
+			}
+
+			m_visibleCommands.push_back(&command);
+		}
+
+		m_stats.visible = m_visibleCommands.size();
+	}
+
+	void RenderQueue::Sort(const CameraData& cameraData)
+	{
+		const size_t count = m_visibleCommands.size();
+		if (count < 2)
+		{
+			return;
+		}
+
+		for (auto command : m_visibleCommands)
+		{
+			const glm::vec4 viewPos = cameraData.viewMatrix * command->modelMatrix[3];
+
+			command->sortKey =
+				MakeKeyField(command->material->GetShaderProgram()->GetID(), ShaderProgramBits, ShaderProgramShift) |
+				MakeKeyField(command->material->GetId(), MaterialBits, MaterialShift) |
+				MakeKeyField(command->mesh->GetId(), MeshBits, MeshShift) |
+				MakeKeyField(QuantizeDepth(-viewPos.z), DepthBits, DepthShift);
+		}
+
+		// LSD radix sort, 8 bits per pass. Passes where every key has the same byte are skipped.
+		m_sortScratch.resize(count);
+		auto* src = m_visibleCommands.data();
+		auto* dst = m_sortScratch.data();
+
+		for (int shift = 0; shift < 64; shift += 8)
+		{
+			size_t histogram[256] = {};
+			for (size_t i = 0; i < count; ++i)
+			{
+				++histogram[(src[i]->sortKey >> shift) & 0xFF];
+			}
+
+			if (histogram[(src[0]->sortKey >> shift) & 0xFF] == count)
+			{
+				continue;
+			}
+
+			size_t offset = 0;
+			for (auto& bucket : histogram)
+			{
+				size_t bucketCount = bucket;
+				bucket = offset;
+				offset += bucketCount;
+			}
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				dst[histogram[(src[i]->sortKey >> shift) & 0xFF]++] = src[i];
+			}
+
+			std::swap(src, dst);
+		}
+
+		if (src != m_visibleCommands.data())
+		{
+			std::memcpy(m_visibleCommands.data(), src, count * sizeof(RenderCommand*));
+		}
+	}
+}
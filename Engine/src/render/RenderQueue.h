@@ -1,6 +1,8 @@
 #pragma once
 #include "Common.h"
 #include <vector>
+#include <cstdint>
+#include <mutex>
 #include <glm/mat4x4.hpp>
 
 namespace eng
@@ -14,15 +16,55 @@ namespace eng
 		Mesh* mesh = nullptr;
 		Material* material = nullptr;
 		glm::mat4 modelMatrix;
+		// Filled by RenderQueue::Draw: shader program | material | mesh | depth, from most to least significant bits
+		uint64_t sortKey = 0;
+	};
+
+	// Counters of the last RenderQueue::Draw call
+	struct RenderStats
+	{
+		size_t submitted = 0;
+		size_t culled = 0;
+		size_t visible = 0;
+		size_t shaderProgramBinds = 0;
+		size_t materialBinds = 0;
+		size_t meshBinds = 0;
+		size_t drawCalls = 0;
+		size_t instancedDrawCalls = 0;
+		size_t instancedCommands = 0;
 	};
 
 	class RenderQueue
 	{
 	public:
+		// Submitting is thread safe, Draw is not and must not overlap with submits
 		void Submit(const RenderCommand& command);
-		void Draw(GraphicsAPI& graphicsAPI, const CameraData& cameraData, const std::vector<LightData>& lights);
+		void Submit(const std::vector<RenderCommand>& commands);
+		// Expects the frame uniforms to be updated already, see GraphicsAPI::UpdateFrameUniforms
+		void Draw(GraphicsAPI& graphicsAPI, const CameraData& cameraData);
+
+		// Runs of at least this many commands sharing mesh and material are drawn instanced, 0 disables instancing
+		void SetMinInstanceBatchSize(size_t size);
+		size_t GetMinInstanceBatchSize() const;
+
+		void SetFrustumCullingEnabled(bool enabled);
+		bool IsFrustumCullingEnabled() const;
+
+		const RenderStats& GetStats() const;
+
+	private:
+		void Cull(const CameraData& cameraData);
+		void Sort(const CameraData& cameraData);
 
 	private:
+		std::mutex m_submitMutex;
 		std::vector<RenderCommand> m_commands;
+		std::vector<RenderCommand*> m_visibleCommands;
+		std::vector<RenderCommand*> m_sortScratch;
+		std::vector<glm::mat4> m_instanceData;
+		unsigned int m_instanceBuffer = 0;
+		size_t m_minInstanceBatchSize = 4;
+		RenderStats m_stats;
+		bool m_frustumCullingEnabled = true;
 	};
-}
\ No newline at end of file
+}
@@ -12,6 +12,10 @@ namespace eng
 	{
 	}
 
+	void Component::OnSpawn()
+	{
+	}
+
 	GameObject* Component::GetOwner()
 	{
 		return m_owner;
@@ -1,4 +1,5 @@
 #pragma once
+#include "memory/PoolAllocator.h"
 #include <json/json.hpp>
 #include <cstddef>
 #include <string>
@@ -16,6 +17,8 @@ namespace eng
 		virtual void LoadProperties(const nlohmann::json& json);
 		virtual void Update(float deltaTime) = 0;
 		virtual void Init();
+		// Called each time the owner is handed out by Scene::Instantiate, new or reused
+		virtual void OnSpawn();
 		virtual size_t GetTypeId() const = 0;
 
 		GameObject* GetOwner();
@@ -31,11 +34,46 @@ namespace eng
 		GameObject* m_owner = nullptr;
 
 		friend class GameObject;
+		friend class Scene;
 
 	private:
+		static constexpr size_t NotInScene = static_cast<size_t>(-1);
+
 		static size_t nextId;
+		// Position in the scene's dense list of components of this type
+		size_t m_sceneIndex = NotInScene;
 	};
 
+	// Pool shared by every component of type T. Never destroyed, components of objects
+	// that outlive static destruction (e.g. the engine's scene) still free into it.
+	template<typename T>
+	PoolAllocator& GetComponentPool()
+	{
+		static PoolAllocator* pool = new PoolAllocator(sizeof(T), alignof(T));
+		return *pool;
+	}
+
+	// Types deriving from a component without their own COMPONENT() have a different size
+	// and go to the global heap instead
+	template<typename T>
+	void* AllocateComponent(size_t size)
+	{
+		return size == sizeof(T) ? GetComponentPool<T>().Allocate() : ::operator new(size);
+	}
+
+	template<typename T>
+	void FreeComponent(void* ptr, size_t size)
+	{
+		if (size == sizeof(T))
+		{
+			GetComponentPool<T>().Deallocate(ptr);
+		}
+		else
+		{
+			::operator delete(ptr);
+		}
+	}
+
 	class ComponentCreatorBase
 	{
 	public:
@@ -74,5 +112,7 @@ namespace eng
 public: \
 	static size_t TypeId() { return eng::Component::StaticTypeId<ComponentClass>(); } \
 	size_t GetTypeId() const override { return TypeId(); } \
-	static void Register() { eng::ComponentFactory::GetInstance().RegisterComponent<ComponentClass>(std::string(#ComponentClass)); }
+	static void Register() { eng::ComponentFactory::GetInstance().RegisterComponent<ComponentClass>(std::string(#ComponentClass)); } \
+	static void* operator new(size_t size) { return eng::AllocateComponent<ComponentClass>(size); } \
+	static void operator delete(void* ptr, size_t size) { eng::FreeComponent<ComponentClass>(ptr, size); }
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "scene/DefaultSystems.h"
+#include "scene/Scene.h"
+#include "render/RenderQueue.h"
+#include "Engine.h"
+
+namespace eng
+{
+	AnimationSystem::AnimationSystem()
+		: ComponentSystem("AnimationSystem", { SystemDataNone, SystemDataLocalTransform | SystemDataWorldTransform })
+	{
+	}
+
+	PhysicsSystem::PhysicsSystem()
+		: ComponentSystem("PhysicsSystem", { SystemDataPhysicsBodies, SystemDataLocalTransform | SystemDataWorldTransform })
+	{
+	}
+
+	TransformSystem::TransformSystem()
+		: SceneSystem("TransformSystem", { SystemDataLocalTransform, SystemDataWorldTransform })
+	{
+	}
+
+	void TransformSystem::Update(Scene& scene, JobSystem& jobSystem, float deltaTime)
+	{
+		scene.UpdateWorldTransforms(jobSystem);
+	}
+
+	MeshSystem::MeshSystem()
+		: ComponentSystem("MeshSystem", { SystemDataWorldTransform, SystemDataRenderQueue })
+	{
+	}
+
+	void MeshSystem::UpdateBatch(Component* const* begin, Component* const* end, float deltaTime)
+	{
+		std::vector<RenderCommand> commands;
+		commands.reserve(static_cast<size_t>(end - begin));
+
+		RenderCommand command;
+		for (auto it = begin; it != end; ++it)
+		{
+			if (static_cast<MeshComponent*>(*it)->BuildRenderCommand(command))
+			{
+				commands.push_back(command);
+			}
+		}
+
+		Engine::GetInstance().GetRenderQueue().Submit(commands);
+	}
+
+	AudioSystem::AudioSystem()
+		: ComponentSystem("AudioSystem", { SystemDataWorldTransform, SystemDataAudioSources })
+	{
+	}
+}
\ No newline at end of file
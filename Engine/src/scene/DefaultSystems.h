@@ -0,0 +1,50 @@
+#pragma once
+#include "scene/SceneSystem.h"
+#include "scene/components/AnimationComponent.h"
+#include "scene/components/PhysicsComponent.h"
+#include "scene/components/MeshComponent.h"
+#include "scene/components/AudioComponent.h"
+
+namespace eng
+{
+	// Sequential, two animations may bind the same objects or one may move an ancestor of objects
+	// another animates, and setting a transform marks the whole subtree below dirty
+	class AnimationSystem : public ComponentSystem<AnimationComponent, false>
+	{
+	public:
+		AnimationSystem();
+	};
+
+	// Sequential, setting a world position reads the parent's lazily built world matrix
+	class PhysicsSystem : public ComponentSystem<PhysicsComponent, false>
+	{
+	public:
+		PhysicsSystem();
+	};
+
+	// Rebuilds every stale world matrix so later systems only read them
+	class TransformSystem : public SceneSystem
+	{
+	public:
+		TransformSystem();
+
+	protected:
+		void Update(Scene& scene, JobSystem& jobSystem, float deltaTime) override;
+	};
+
+	// Submits one batch of commands per job instead of one command per component
+	class MeshSystem : public ComponentSystem<MeshComponent>
+	{
+	public:
+		MeshSystem();
+
+	protected:
+		void UpdateBatch(Component* const* begin, Component* const* end, float deltaTime) override;
+	};
+
+	class AudioSystem : public ComponentSystem<AudioComponent>
+	{
+	public:
+		AudioSystem();
+	};
+}
\ No newline at end of file
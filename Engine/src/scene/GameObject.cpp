@@ -6,7 +6,10 @@
 #include "render/Mesh.h"
 #include "scene/components/MeshComponent.h"
 #include "scene/components/AnimationComponent.h"
+#include "profiling/Profiler.h"
+#include "memory/SizeClassAllocator.h"
 
+#include <algorithm>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -20,6 +23,38 @@
 
 namespace eng
 {
+	namespace
+	{
+		// Never destroyed, objects may be freed during static destruction
+		SizeClassAllocator& GetObjectAllocator()
+		{
+			static SizeClassAllocator* allocator = new SizeClassAllocator();
+			return *allocator;
+		}
+	}
+
+	GameObject::~GameObject()
+	{
+		if (m_scene)
+		{
+			m_scene->ReleaseHandle(m_handle);
+			for (auto& component : m_components)
+			{
+				m_scene->UnregisterComponent(component.get());
+			}
+		}
+	}
+
+	void* GameObject::operator new(size_t size)
+	{
+		return GetObjectAllocator().Allocate(size);
+	}
+
+	void GameObject::operator delete(void* ptr, size_t size)
+	{
+		GetObjectAllocator().Deallocate(ptr, size);
+	}
+
 	void GameObject::Init()
 	{
 	}
@@ -35,22 +70,49 @@ namespace eng
 			return;
 		}
 
+		// Systems pick up the components of objects stamped with the current update
+		if (m_scene)
+		{
+			m_lastUpdateFrame = m_scene->m_updateFrame;
+		}
 		for (auto& component : m_components)
 		{
+			if (m_scene && m_scene->IsUpdatedBySystem(component.get()))
+			{
+				continue;
+			}
 			component->Update(deltaTime);
 		}
-		for (auto it = m_children.begin(); it != m_children.end();)
+		// By index, children may be added while iterating. Dead ones are compacted once afterwards.
+		bool hasDeadChildren = false;
+		for (size_t i = 0; i < m_children.size(); ++i)
 		{
-			if ((*it)->IsAlive())
+			if (m_children[i]->IsAlive())
 			{
-				(*it)->Update(deltaTime);
-				++it;
+				m_children[i]->Update(deltaTime);
 			}
 			else
 			{
-				it = m_children.erase(it);
+				hasDeadChildren = true;
 			}
 		}
+		// Destroyed with the rest of the frame's dead objects when the scene flushes
+		if (hasDeadChildren && m_scene)
+		{
+			RemoveDeadObjects(m_children, m_scene->m_destroyQueue);
+		}
+	}
+
+	void GameObject::OnSpawn()
+	{
+		for (auto& component : m_components)
+		{
+			component->OnSpawn();
+		}
+		for (auto& child : m_children)
+		{
+			child->OnSpawn();
+		}
 	}
 
 	const std::string& GameObject::GetName() const
@@ -82,6 +144,11 @@ namespace eng
 	{
 		return m_scene;
 	}
+
+	GameObjectHandle GameObject::GetHandle() const
+	{
+		return m_handle;
+	}
 	
 	bool GameObject::IsAlive() const
 	{
@@ -112,6 +179,23 @@ namespace eng
 
 		m_components.emplace_back(component);
 		component->m_owner = this;
+		if (m_scene)
+		{
+			m_scene->RegisterComponent(component);
+		}
+
+		const size_t typeId = component->GetTypeId();
+		if (typeId < MaxIndexedComponentTypes)
+		{
+			const uint64_t bit = uint64_t(1) << typeId;
+			if ((m_componentMask & bit) == 0)
+			{
+				const size_t slot = CountBits(m_componentMask & (bit - 1));
+				m_componentIndex.insert(m_componentIndex.begin() + slot, component);
+				m_componentMask |= bit;
+			}
+		}
+
 		component->Init();
 	}
 
@@ -147,6 +231,8 @@ namespace eng
 	void GameObject::SetPosition(const glm::vec3& pos)
 	{
 		m_position = pos;
+		m_localDirty = true;
+		MarkWorldTransformDirty();
 	}
 
 	void GameObject::SetWorldPosition(const glm::vec3& pos)
@@ -185,6 +271,8 @@ namespace eng
 	void GameObject::SetRotation(const glm::quat& rot)
 	{
 		m_rotation = rot;
+		m_localDirty = true;
+		MarkWorldTransformDirty();
 	}
 
 	void GameObject::SetWorldRotation(const glm::quat& rot)
@@ -210,33 +298,104 @@ namespace eng
 	void GameObject::SetScale(const glm::vec3& scale)
 	{
 		m_scale = scale;
+		m_localDirty = true;
+		MarkWorldTransformDirty();
 	}
 
-	glm::mat4 GameObject::GetLocalTransform() const
+	const glm::mat4& GameObject::GetLocalTransform() const
 	{
-		glm::mat4 mat = glm::mat4(1.0f);
+		if (m_localDirty)
+		{
+			glm::mat4 mat = glm::mat4(1.0f);
+
+			// Translation
+			mat = glm::translate(mat, m_position);
 
-		// Translation
-		mat = glm::translate(mat, m_position);
+			// Rotation
+			mat = mat * glm::mat4_cast(m_rotation);
 
-		// Rotation
-		mat = mat * glm::mat4_cast(m_rotation);
+			// Scale
+			mat = glm::scale(mat, m_scale);
 
-		// Scale
-		mat = glm::scale(mat, m_scale);
+			m_localTransform = mat;
+			m_localDirty = false;
+		}
 
-		return mat;
+		return m_localTransform;
 	}
 
-	glm::mat4 GameObject::GetWorldTransform() const
+	const glm::mat4& GameObject::GetWorldTransform() const
 	{
-		if (m_parent)
+		if (m_worldDirty)
 		{
-			return m_parent->GetWorldTransform() * GetLocalTransform();
+			if (m_parent)
+			{
+				m_worldTransform = m_parent->GetWorldTransform() * GetLocalTransform();
+			}
+			else
+			{
+				m_worldTransform = GetLocalTransform();
+			}
+			m_worldDirty = false;
 		}
-		else
+
+		return m_worldTransform;
+	}
+
+	void GameObject::UpdateWorldTransforms()
+	{
+		GetWorldTransform();
+		for (auto& child : m_children)
 		{
-			return GetLocalTransform();
+			child->UpdateWorldTransforms();
+		}
+	}
+
+	bool GameObject::IsInTree() const
+	{
+		return m_indexInParent != NotInTree;
+	}
+
+	void GameObject::RemoveDeadObjects(std::vector<std::unique_ptr<GameObject>>& objects, std::vector<std::unique_ptr<GameObject>>& destroyed)
+	{
+		auto firstDead = std::find_if(objects.begin(), objects.end(), [](const std::unique_ptr<GameObject>& obj) { return !obj->IsAlive(); });
+		if (firstDead == objects.end())
+		{
+			return;
+		}
+
+		// Only objects behind the first dead one move
+		size_t kept = static_cast<size_t>(firstDead - objects.begin());
+		for (size_t i = kept; i < objects.size(); ++i)
+		{
+			if (!objects[i]->IsAlive())
+			{
+				objects[i]->m_indexInParent = NotInTree;
+				destroyed.push_back(std::move(objects[i]));
+				continue;
+			}
+			objects[i]->m_indexInParent = kept;
+			if (i != kept)
+			{
+				objects[kept] = std::move(objects[i]);
+			}
+			++kept;
+		}
+		objects.resize(kept);
+	}
+
+	void GameObject::MarkWorldTransformDirty()
+	{
+		// Already dirty means the whole subtree is dirty as well
+		if (m_worldDirty)
+		{
+			return;
+		}
+
+		m_worldDirty = true;
+		for (auto& child : m_children)
+		{
+			child->MarkWorldTransformDirty();
 		}
 	}
 
@@ -505,6 +664,8 @@ namespace eng
 
 	GameObject* GameObject::LoadGLTF(const std::string& path, Scene* gameScene)
 	{
+		PROFILE_SCOPE("GameObject::LoadGLTF");
+
 		auto contents = Engine::GetInstance().GetFileSystem().LoadAssetFileText(path);
 		if (contents.empty())
 		{
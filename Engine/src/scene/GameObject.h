@@ -1,8 +1,10 @@
 #pragma once
 #include "scene/Component.h"
+#include "scene/GameObjectHandle.h"
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstdint>
 #include <glm/vec3.hpp>
 #include <glm/mat4x4.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -10,29 +12,53 @@
 namespace eng
 {
 	class Scene;
+	class Prefab;
 	class GameObject
 	{
 	public:
-		virtual ~GameObject() = default;
+		virtual ~GameObject();
+
+		// Objects of every GameObject class come from size class pools instead of the global heap
+		static void* operator new(size_t size);
+		static void operator delete(void* ptr, size_t size);
+
 		virtual void Init();
 		virtual void LoadProperties(const nlohmann::json& json);
 		virtual void Update(float deltaTime);
+		// Called each time Scene::Instantiate hands the object out, a reused instance resets its state here.
+		// Components and children get theirs as well.
+		virtual void OnSpawn();
 		const std::string& GetName() const;
 		void SetName(const std::string& name);
 		GameObject* GetParent();
 		bool SetParent(GameObject* parent);
 		Scene* GetScene();
+		// Invalid until the object was created through a scene
+		GameObjectHandle GetHandle() const;
 		bool IsAlive() const;
 		void MarkForDestroy();
 		
 		void SetActive(bool active);
 		bool IsActive() const;
 
+		// Component types with an id below this are found through the mask, later ones by a scan
+		static constexpr size_t MaxIndexedComponentTypes = 64;
+
 		void AddComponent(Component* component);
+		// First component of type T
 		template<typename T, typename = typename std::enable_if_t<std::is_base_of_v<Component, T>>>
 		T* GetComponent()
 		{
-			size_t typeId = Component::StaticTypeId<T>();
+			const size_t typeId = Component::StaticTypeId<T>();
+			if (typeId < MaxIndexedComponentTypes)
+			{
+				const uint64_t bit = uint64_t(1) << typeId;
+				if ((m_componentMask & bit) == 0)
+				{
+					return nullptr;
+				}
+				return static_cast<T*>(m_componentIndex[CountBits(m_componentMask & (bit - 1))]);
+			}
 
 			for (auto& component : m_components)
 			{
@@ -44,6 +70,25 @@ namespace eng
 			return nullptr;
 		}
 
+		// True if the object has a component of every listed type
+		template<typename... Ts>
+		bool HasComponents()
+		{
+			static_assert(sizeof...(Ts) > 0, "HasComponents needs at least one type");
+			const size_t typeIds[] = { Component::StaticTypeId<Ts>()... };
+
+			uint64_t mask = 0;
+			for (size_t typeId : typeIds)
+			{
+				if (typeId >= MaxIndexedComponentTypes)
+				{
+					return (... && (GetComponent<Ts>() != nullptr));
+				}
+				mask |= uint64_t(1) << typeId;
+			}
+			return (m_componentMask & mask) == mask;
+		}
+
 		GameObject* FindChildByName(const std::string& name);
 
 		const glm::vec3& GetPosition() const;
@@ -59,26 +104,71 @@ namespace eng
 		const glm::vec3& GetScale() const;
 		void SetScale(const glm::vec3& scale);
 
-		glm::mat4 GetLocalTransform() const;
-		glm::mat4 GetWorldTransform() const;
+		const glm::mat4& GetLocalTransform() const;
+		const glm::mat4& GetWorldTransform() const;
+		// Rebuilds the stale world matrices of this object and its descendants
+		void UpdateWorldTransforms();
 
 		static GameObject* LoadGLTF(const std::string& path, Scene* gameScene);
 
 	protected:
 		GameObject() = default;
 
+	private:
+		// Marks the cached world matrices of this object and all its descendants as stale
+		void MarkWorldTransformDirty();
+
+		static constexpr size_t NotInTree = static_cast<size_t>(-1);
+		static constexpr size_t NotPending = static_cast<size_t>(-1);
+		bool IsInTree() const;
+		// One pass over the list, keeps the order of the survivors and their indices up to date.
+		// Dead objects are moved to destroyed instead of being deleted in place.
+		static void RemoveDeadObjects(std::vector<std::unique_ptr<GameObject>>& objects, std::vector<std::unique_ptr<GameObject>>& destroyed);
+
+		static size_t CountBits(uint64_t value)
+		{
+#if defined (__GNUC__) || defined (__clang__)
+			return static_cast<size_t>(__builtin_popcountll(value));
+#else
+			value = value - ((value >> 1) & 0x5555555555555555ull);
+			value = (value & 0x3333333333333333ull) + ((value >> 2) & 0x3333333333333333ull);
+			value = (value + (value >> 4)) & 0x0f0f0f0f0f0f0f0full;
+			return static_cast<size_t>((value * 0x0101010101010101ull) >> 56);
+#endif
+		}
+
 	protected:
 		std::string m_name;
 		GameObject* m_parent = nullptr;
 		Scene* m_scene = nullptr;
+		GameObjectHandle m_handle;
+		// Prefab the object was instantiated from, it goes back to that prefab's pool when destroyed
+		const Prefab* m_prefab = nullptr;
 		std::vector<std::unique_ptr<GameObject>> m_children;
+		// Position in the parent's m_children or the scene's root list
+		size_t m_indexInParent = NotInTree;
+		// Position in the scene's m_objectsToAdd while it waits for the end of Update, which owns it then
+		size_t m_pendingIndex = NotPending;
 		std::vector<std::unique_ptr<Component>> m_components;
+		// Bit per indexed component type present, m_componentIndex holds the first component
+		// of each of those types ordered by type id
+		uint64_t m_componentMask = 0;
+		std::vector<Component*> m_componentIndex;
 		bool m_isAlive = true;
+		// Scene update the tree walk last reached the object in
+		uint64_t m_lastUpdateFrame = 0;
 		glm::vec3 m_position = glm::vec3(0.0f);
 		glm::quat m_rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
 		glm::vec3 m_scale = glm::vec3(1.0f);
 		bool m_active = true;
 
+		// Cached transforms, rebuilt lazily on the next Get*Transform call.
+		// Invariant: if an object is world-dirty, so are all of its descendants.
+		mutable glm::mat4 m_localTransform = glm::mat4(1.0f);
+		mutable glm::mat4 m_worldTransform = glm::mat4(1.0f);
+		mutable bool m_localDirty = true;
+		mutable bool m_worldDirty = true;
+
 		friend class Scene;
 	};
 
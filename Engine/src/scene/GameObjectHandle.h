@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+
+namespace eng
+{
+	// Weak reference to a scene object. Resolving it through Scene::Resolve gives null once
+	// the object was destroyed or marked for destroy, even if its slot was reused since.
+	struct GameObjectHandle
+	{
+		static constexpr uint32_t InvalidIndex = 0xffffffffu;
+
+		uint32_t index = InvalidIndex;
+		uint32_t generation = 0;
+
+		bool IsValid() const { return index != InvalidIndex; }
+
+		bool operator == (const GameObjectHandle& other) const { return index == other.index && generation == other.generation; }
+		bool operator != (const GameObjectHandle& other) const { return !(*this == other); }
+	};
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "scene/Prefab.h"
+#include "Engine.h"
+
+namespace eng
+{
+	std::shared_ptr<Prefab> Prefab::Create(const std::string& type, Setup setup)
+	{
+		auto result = std::make_shared<Prefab>();
+		result->m_type = type;
+		result->m_setup = std::move(setup);
+		return result;
+	}
+
+	std::shared_ptr<Prefab> Prefab::Load(const std::string& path)
+	{
+		const std::string contents = Engine::GetInstance().GetFileSystem().LoadAssetFileText(path);
+		if (contents.empty())
+		{
+			return nullptr;
+		}
+
+		auto json = nlohmann::json::parse(contents);
+		return LoadFromJson(json);
+	}
+
+	std::shared_ptr<Prefab> Prefab::LoadFromJson(const nlohmann::json& json)
+	{
+		if (!json.is_object())
+		{
+			return nullptr;
+		}
+
+		auto result = std::make_shared<Prefab>();
+		result->m_type = json.value("type", "");
+		result->m_description = json;
+		return result;
+	}
+
+	void Prefab::SetPoolCapacity(size_t capacity)
+	{
+		m_poolCapacity = capacity;
+	}
+
+	size_t Prefab::GetPoolCapacity() const
+	{
+		return m_poolCapacity;
+	}
+}
\ No newline at end of file
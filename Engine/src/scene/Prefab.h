@@ -0,0 +1,39 @@
+#pragma once
+#include <json/json.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace eng
+{
+	class GameObject;
+
+	// Template for objects spawned often. Resources the setup captures or the description
+	// loads are shared by all instances, Scene::Instantiate reuses destroyed instances.
+	class Prefab
+	{
+	public:
+		static constexpr size_t DefaultPoolCapacity = 128;
+
+		// Fills a freshly created instance, only called when the pool has none to reuse
+		using Setup = std::function<void(GameObject& obj)>;
+
+		// Type is a registered GameObject type, empty for a plain GameObject
+		static std::shared_ptr<Prefab> Create(const std::string& type, Setup setup);
+		// Same description as an object of a scene file
+		static std::shared_ptr<Prefab> Load(const std::string& path);
+		static std::shared_ptr<Prefab> LoadFromJson(const nlohmann::json& json);
+
+		// Destroyed instances kept per scene for reuse, the rest are deleted
+		void SetPoolCapacity(size_t capacity);
+		size_t GetPoolCapacity() const;
+
+	private:
+		std::string m_type;
+		Setup m_setup;
+		nlohmann::json m_description;
+		size_t m_poolCapacity = DefaultPoolCapacity;
+
+		friend class Scene;
+	};
+}
\ No newline at end of file
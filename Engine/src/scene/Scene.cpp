@@ -7,7 +7,10 @@
 #include "scene/components/PhysicsComponent.h"
 #include "scene/components/AudioComponent.h"
 #include "scene/components/AudioListenerComponent.h"
+#include "scene/DefaultSystems.h"
 #include "Engine.h"
+#include "profiling/Profiler.h"
+#include <algorithm>
 
 namespace eng
 {
@@ -25,228 +28,610 @@ namespace eng
 
 	void Scene::Update(float deltaTime)
 	{
-		m_objects.erase(
-			std::remove_if(m_objects.begin(), m_objects.end(),
-				[](const std::unique_ptr<GameObject>& obj) { return !obj->IsAlive(); }),
-			m_objects.end()
-		);
+		PROFILE_SCOPE("Scene::Update");
 
-		for (auto& obj : m_objectsToAdd)
+		// Creation order, so an object created under another new object finds its parent in the tree
+		for (auto& pending : m_objectsToAdd)
 		{
-			SetParent(obj.first, obj.second);
+			pending.object->m_pendingIndex = GameObject::NotPending;
+			auto parent = Resolve(pending.parent);
+			if (!pending.object->IsAlive() || (pending.parent.IsValid() && !parent))
+			{
+				// Destroyed already or the parent went away in the meantime, the child would have gone with it
+				m_destroyQueue.push_back(std::move(pending.object));
+				continue;
+			}
+			if (pending.spawn)
+			{
+				m_pendingSpawns.push_back(pending.object.get());
+			}
+			auto obj = pending.object.release();
+			if (!SetParent(obj, parent))
+			{
+				// Reparented under its own pending descendant in the meantime, the root takes it instead of nobody
+				SetParent(obj, nullptr);
+			}
 		}
 		m_objectsToAdd.clear();
 
+		// Children of new instances were further down the list, the subtrees are complete only now
+		for (auto obj : m_pendingSpawns)
+		{
+			obj->OnSpawn();
+		}
+		m_pendingSpawns.clear();
+
+		++m_updateFrame;
 		m_isUpdating = true;
-		for (auto it = m_objects.begin(); it != m_objects.end();)
+		// By index, objects may be added while iterating. Dead ones are removed once the update is over.
+		for (size_t i = 0; i < m_objects.size(); ++i)
 		{
-			if ((*it)->IsAlive())
+			if (m_objects[i]->IsAlive())
 			{
-				(*it)->Update(deltaTime);
-				++it;
+				m_objects[i]->Update(deltaTime);
 			}
-			else
+		}
+
+		if (m_parallelUpdate)
+		{
+			RunSystems(deltaTime);
+		}
+		m_isUpdating = false;
+
+		GameObject::RemoveDeadObjects(m_objects, m_destroyQueue);
+		FlushDestroyQueue();
+	}
+
+	void Scene::SetParallelUpdateEnabled(bool enabled)
+	{
+		m_parallelUpdate = enabled;
+		if (enabled && m_systems.empty())
+		{
+			AddSystem(std::make_unique<AnimationSystem>());
+			AddSystem(std::make_unique<PhysicsSystem>());
+			AddSystem(std::make_unique<TransformSystem>());
+			AddSystem(std::make_unique<MeshSystem>());
+			AddSystem(std::make_unique<AudioSystem>());
+		}
+	}
+
+	bool Scene::IsParallelUpdateEnabled() const
+	{
+		return m_parallelUpdate;
+	}
+
+	void Scene::AddSystem(std::unique_ptr<SceneSystem> system)
+	{
+		if (!system)
+		{
+			return;
+		}
+
+		const size_t typeId = system->GetComponentTypeId();
+		if (typeId != SceneSystem::NoComponentType)
+		{
+			if (typeId >= m_systemByTypeId.size())
 			{
-				it = m_objects.erase(it);
+				m_systemByTypeId.resize(typeId + 1, nullptr);
 			}
+			m_systemByTypeId[typeId] = system.get();
 		}
-		m_isUpdating = false;
+
+		// A system may only join the last phase, so systems never run before one added earlier
+		bool joinsLastPhase = !m_systemPhases.empty();
+		if (joinsLastPhase)
+		{
+			for (auto other : m_systemPhases.back())
+			{
+				if (system->GetAccess().ConflictsWith(other->GetAccess()))
+				{
+					joinsLastPhase = false;
+					break;
+				}
+			}
+		}
+		if (!joinsLastPhase)
+		{
+			m_systemPhases.emplace_back();
+		}
+		m_systemPhases.back().push_back(system.get());
+
+		m_systems.push_back(std::move(system));
 	}
 
-	void Scene::Clear()
+	bool Scene::IsUpdatedBySystem(const Component* component) const
 	{
-		m_objects.clear();
+		if (!m_parallelUpdate)
+		{
+			return false;
+		}
+
+		const size_t typeId = component->GetTypeId();
+		return typeId < m_systemByTypeId.size() && m_systemByTypeId[typeId];
 	}
 
-	GameObject* Scene::CreateObject(const std::string& name, GameObject* parent)
+	const std::vector<Component*>& Scene::GetComponents(size_t typeId) const
 	{
-		auto obj = new GameObject();
-		obj->SetName(name);
-		obj->m_scene = this;
-		if (m_isUpdating)
+		static const std::vector<Component*> none;
+		return typeId < m_componentsByType.size() ? m_componentsByType[typeId] : none;
+	}
+
+	bool Scene::IsUpdatedThisFrame(const GameObject* obj) const
+	{
+		return obj->m_lastUpdateFrame == m_updateFrame;
+	}
+
+	void Scene::RegisterComponent(Component* component)
+	{
+		const size_t typeId = component->GetTypeId();
+		if (typeId >= m_componentsByType.size())
 		{
-			m_objectsToAdd.push_back({ obj, parent });
+			m_componentsByType.resize(typeId + 1);
 		}
-		else
+
+		auto& components = m_componentsByType[typeId];
+		component->m_sceneIndex = components.size();
+		components.push_back(component);
+	}
+
+	void Scene::UnregisterComponent(Component* component)
+	{
+		if (component->m_sceneIndex == Component::NotInScene)
 		{
-			SetParent(obj, parent);
+			return;
 		}
-		return obj;
+
+		auto& components = m_componentsByType[component->GetTypeId()];
+		auto last = components.back();
+		components[component->m_sceneIndex] = last;
+		last->m_sceneIndex = component->m_sceneIndex;
+		components.pop_back();
+		component->m_sceneIndex = Component::NotInScene;
 	}
 
-	GameObject* Scene::CreateObject(const std::string& type, const std::string& name, GameObject* parent)
+	void Scene::RegisterComponents(GameObject* obj)
 	{
-		auto obj = GameObjectFactory::GetInstance().CreateGameObject(type);
-		if (obj)
+		for (auto& component : obj->m_components)
 		{
-			obj->SetName(name);
-			obj->m_scene = this;
-			if (m_isUpdating)
+			RegisterComponent(component.get());
+		}
+	}
+
+	void Scene::UpdateWorldTransforms(JobSystem& jobSystem)
+	{
+		jobSystem.ParallelFor(m_objects.size(), 1, [this](size_t begin, size_t end)
 			{
-				m_objectsToAdd.push_back({ obj, parent });
-			}
-			else
+				for (size_t i = begin; i < end; ++i)
+				{
+					m_objects[i]->UpdateWorldTransforms();
+				}
+			});
+	}
+
+	void Scene::RunSystems(float deltaTime)
+	{
+		PROFILE_SCOPE("Scene::RunSystems");
+
+		auto& jobSystem = Engine::GetInstance().GetJobSystem();
+		for (auto& phase : m_systemPhases)
+		{
+			// The calling thread runs the first system of the phase itself
+			JobCounter counter;
+			for (size_t i = 1; i < phase.size(); ++i)
 			{
-				SetParent(obj, parent);
+				auto system = phase[i];
+				jobSystem.Run([this, system, &jobSystem, deltaTime]() { system->Run(*this, jobSystem, deltaTime); }, &counter);
 			}
+			phase.front()->Run(*this, jobSystem, deltaTime);
+			jobSystem.Wait(counter);
 		}
-		return obj;
 	}
 
-	bool Scene::SetParent(GameObject* obj, GameObject* parent)
+	void Scene::FlushDestroyQueue()
 	{
-		bool result = false;
-		auto currentParent = obj->GetParent();
+		if (m_destroyQueue.empty())
+		{
+			return;
+		}
+
+		PROFILE_SCOPE("Scene::FlushDestroyQueue");
 
-		if (parent == nullptr)
+		// Prefab instances go back to their pool while it has room, whole subtree included
+		for (auto& obj : m_destroyQueue)
 		{
-			if (currentParent != nullptr)
+			auto poolIt = obj->m_prefab ? m_prefabPools.find(obj->m_prefab) : m_prefabPools.end();
+			const bool pooled = poolIt != m_prefabPools.end() &&
+				poolIt->second.objects.size() < poolIt->second.prefab->GetPoolCapacity();
+			m_flushStack.emplace_back(obj.get(), pooled);
+			if (pooled)
 			{
-				auto it = std::find_if(
-					currentParent->m_children.begin(),
-					currentParent->m_children.end(),
-					[obj](const std::unique_ptr<GameObject>& el)
-					{
-						return el.get() == obj;
-					}
-				);
+				obj->m_parent = nullptr;
+				poolIt->second.objects.push_back(std::move(obj));
+			}
+		}
 
-				if (it != currentParent->m_children.end())
-				{
-					m_objects.push_back(std::move(*it));
-					obj->m_parent = nullptr;
-					currentParent->m_children.erase(it);
-					result = true;
-				}
+		// Depth first over every queued subtree. Pooled objects only leave the physics world,
+		// they keep their voices and stay registered as lights that are skipped while dead.
+		while (!m_flushStack.empty())
+		{
+			auto entry = m_flushStack.back();
+			m_flushStack.pop_back();
+			for (auto& child : entry.first->m_children)
+			{
+				m_flushStack.emplace_back(child.get(), entry.second);
 			}
-			// No parent currently. This can be in 2 cases
-			// 1. The object is in the scene root
-			// 2. The object has been just created
-			else
+
+			// The whole pooled subtree stops resolving, Instantiate hands out new handles
+			if (entry.second)
+			{
+				ReleaseHandle(entry.first->m_handle);
+				entry.first->m_handle = GameObjectHandle();
+			}
+
+			for (auto& component : entry.first->m_components)
 			{
-				auto it = std::find_if(
-					m_objects.begin(),
-					m_objects.end(),
-					[obj](const std::unique_ptr<GameObject>& el)
+				const size_t typeId = component->GetTypeId();
+				if (typeId == PhysicsComponent::TypeId())
+				{
+					// A destroyed body still shared with someone else stays in the world
+					auto& body = static_cast<PhysicsComponent*>(component.get())->GetRigidBody();
+					if (body && (entry.second || body.use_count() == 1))
 					{
-						return el.get() == obj;
+						m_releasedBodies.push_back(body.get());
 					}
-				);
-
-				if (it == m_objects.end())
+				}
+				else if (entry.second)
 				{
-					std::unique_ptr<GameObject> objHolder(obj);
-					m_objects.push_back(std::move(objHolder));
-					result = true;
+					continue;
+				}
+				else if (typeId == AudioComponent::TypeId())
+				{
+					static_cast<AudioComponent*>(component.get())->ReleaseClips(m_releasedClips);
+				}
+				else if (typeId == LightComponent::TypeId())
+				{
+					m_releasedLights.push_back(static_cast<LightComponent*>(component.get()));
 				}
 			}
 		}
-		// We are trying to add it as a child of another object
+
+		// Component destructors find nothing left to unregister afterwards
+		Engine::GetInstance().GetPhysicsManager().RemoveRigidBodies(m_releasedBodies);
+		UnregisterLights(m_releasedLights);
+		m_releasedBodies.clear();
+		m_releasedLights.clear();
+		m_releasedClips.clear();
+		m_destroyQueue.clear();
+	}
+
+	void Scene::Clear()
+	{
+		// Pools go first, so the objects of the tree are destroyed instead of pooled
+		m_prefabPools.clear();
+		for (auto& obj : m_objects)
+		{
+			obj->m_indexInParent = GameObject::NotInTree;
+			m_destroyQueue.push_back(std::move(obj));
+		}
+		m_objects.clear();
+		FlushDestroyQueue();
+	}
+
+	GameObject* Scene::CreateObject(const std::string& name, GameObject* parent)
+	{
+		auto obj = new GameObject();
+		AddObject(obj, name, parent);
+		return obj;
+	}
+
+	GameObject* Scene::CreateObject(const std::string& type, const std::string& name, GameObject* parent)
+	{
+		auto obj = GameObjectFactory::GetInstance().CreateGameObject(type);
+		if (obj)
+		{
+			AddObject(obj, name, parent);
+		}
+		return obj;
+	}
+
+	GameObject* Scene::Resolve(GameObjectHandle handle) const
+	{
+		if (handle.index >= m_objectSlots.size())
+		{
+			return nullptr;
+		}
+
+		const auto& slot = m_objectSlots[handle.index];
+		if (slot.generation != handle.generation || !slot.object || !slot.object->IsAlive())
+		{
+			return nullptr;
+		}
+		return slot.object;
+	}
+
+	GameObject* Scene::Instantiate(const std::shared_ptr<Prefab>& prefab, const glm::vec3& position, const glm::quat& rotation, GameObject* parent)
+	{
+		if (!prefab)
+		{
+			return nullptr;
+		}
+
+		auto poolIt = m_prefabPools.find(prefab.get());
+		if (poolIt == m_prefabPools.end())
+		{
+			poolIt = m_prefabPools.emplace(prefab.get(), PrefabPool()).first;
+			poolIt->second.prefab = prefab;
+			poolIt->second.objects.reserve(prefab->GetPoolCapacity());
+		}
+
+		// Entries added from here on belong to this instance if it is deferred
+		const size_t firstPending = m_objectsToAdd.size();
+		GameObject* obj = nullptr;
+		auto& pooled = poolIt->second.objects;
+		if (!pooled.empty())
+		{
+			std::unique_ptr<GameObject> reused = std::move(pooled.back());
+			pooled.pop_back();
+			obj = reused.get();
+			obj->m_isAlive = true;
+			obj->m_active = true;
+			AssignHandles(obj);
+			InsertObject(std::move(reused), parent);
+		}
 		else
 		{
-			if (currentParent != nullptr)
+			obj = BuildInstance(*prefab, parent);
+			if (!obj)
 			{
-				auto it = std::find_if(
-					currentParent->m_children.begin(),
-					currentParent->m_children.end(),
-					[obj](const std::unique_ptr<GameObject>& el)
-					{
-						return el.get() == obj;
-					}
-				);
+				return nullptr;
+			}
+			obj->m_prefab = prefab.get();
+		}
 
-				if (it != currentParent->m_children.end())
-				{
-					bool found = false;
-					auto currentElement = parent;
-					while (currentElement)
-					{
-						if (currentElement == obj)
-						{
-							found = true;
-							break;
-						}
-						currentElement = currentElement->GetParent();
-					}
+		obj->SetPosition(position);
+		obj->SetRotation(rotation);
 
-					if (!found)
-					{
-						parent->m_children.push_back(std::move(*it));
-						obj->m_parent = parent;
-						currentParent->m_children.erase(it);
-						result = true;
-					}
-				}
+		// Deferred under a parent or with deferred children, world transforms are unknown until Update attaches them
+		for (size_t i = firstPending; i < m_objectsToAdd.size(); ++i)
+		{
+			if (m_objectsToAdd[i].object.get() == obj && (parent || i + 1 < m_objectsToAdd.size()))
+			{
+				m_objectsToAdd[i].spawn = true;
+				return obj;
 			}
-			// No parent currently. This can be in 2 cases
-			// 1. The object is in the scene root
-			// 2. The object has been just created
-			else
+		}
+		obj->OnSpawn();
+		return obj;
+	}
+
+	GameObject* Scene::BuildInstance(const Prefab& prefab, GameObject* parent)
+	{
+		PROFILE_SCOPE("Scene::BuildInstance");
+
+		if (!prefab.m_description.is_null())
+		{
+			return LoadObject(prefab.m_description, parent);
+		}
+
+		auto obj = prefab.m_type.empty() ? CreateObject(std::string("Object"), parent) : CreateObject(prefab.m_type, prefab.m_type, parent);
+		if (!obj)
+		{
+			return nullptr;
+		}
+		if (prefab.m_setup)
+		{
+			prefab.m_setup(*obj);
+		}
+		obj->Init();
+		return obj;
+	}
+
+	void Scene::AddObject(GameObject* obj, const std::string& name, GameObject* parent)
+	{
+		obj->SetName(name);
+		obj->m_scene = this;
+		RegisterComponents(obj);
+		AssignHandle(obj);
+		InsertObject(std::unique_ptr<GameObject>(obj), parent);
+	}
+
+	void Scene::AssignHandle(GameObject* obj)
+	{
+		uint32_t index = 0;
+		if (m_freeObjectSlots.empty())
+		{
+			index = static_cast<uint32_t>(m_objectSlots.size());
+			m_objectSlots.emplace_back();
+		}
+		else
+		{
+			index = m_freeObjectSlots.back();
+			m_freeObjectSlots.pop_back();
+		}
+		m_objectSlots[index].object = obj;
+		obj->m_handle = { index, m_objectSlots[index].generation };
+	}
+
+	void Scene::AssignHandles(GameObject* obj)
+	{
+		AssignHandle(obj);
+		for (auto& child : obj->m_children)
+		{
+			AssignHandles(child.get());
+		}
+	}
+
+	void Scene::InsertObject(std::unique_ptr<GameObject> obj, GameObject* parent)
+	{
+		if (m_isUpdating)
+		{
+			obj->m_pendingIndex = m_objectsToAdd.size();
+			m_objectsToAdd.push_back({ std::move(obj), parent ? parent->GetHandle() : GameObjectHandle() });
+		}
+		else
+		{
+			SetParent(obj.release(), parent);
+		}
+	}
+
+	void Scene::ReleaseHandle(GameObjectHandle handle)
+	{
+		if (handle.index >= m_objectSlots.size() || m_objectSlots[handle.index].generation != handle.generation)
+		{
+			return;
+		}
+
+		// Bumping the generation invalidates every handle to the old object
+		auto& slot = m_objectSlots[handle.index];
+		slot.object = nullptr;
+		++slot.generation;
+		m_freeObjectSlots.push_back(handle.index);
+	}
+
+	bool Scene::SetParent(GameObject* obj, GameObject* parent)
+	{
+		if (obj->m_parent == parent && obj->IsInTree())
+		{
+			return false;
+		}
+
+		// Out of the tree and dead means it waits in the destroy queue
+		if (!obj->IsAlive() && !obj->IsInTree())
+		{
+			return false;
+		}
+
+		// Objects without a handle sit in a prefab pool
+		if (!obj->m_handle.IsValid() || (parent && !parent->m_handle.IsValid()))
+		{
+			return false;
+		}
+
+		// An object can not become a child of itself or one of its descendants
+		for (auto ancestor = parent; ancestor; ancestor = ancestor->GetParent())
+		{
+			if (ancestor == obj)
 			{
-				auto it = std::find_if(
-					m_objects.begin(),
-					m_objects.end(),
-					[obj](const std::unique_ptr<GameObject>& el)
-					{
-						return el.get() == obj;
-					}
-				);
-				// The object has been just created
-				if (it == m_objects.end())
-				{
-					std::unique_ptr<GameObject> objHolder(obj);
-					parent->m_children.push_back(std::move(objHolder));
-					obj->m_parent = parent;
-					result = true;
-				}
-				else
-				{
-					bool found = false;
-					auto currentElement = parent;
-					while (currentElement)
-					{
-						if (currentElement == obj)
-						{
-							found = true;
-							break;
-						}
-						currentElement = currentElement->GetParent();
-					}
-					if (!found)
-					{
-						parent->m_children.push_back(std::move(*it));
-						obj->m_parent = parent;
-						m_objects.erase(it);
-						result = true;
-					}
-				}
+				return false;
 			}
 		}
-		return result;
+
+		// The pending entry keeps owning the object, it only goes to the new parent once Update is over
+		if (obj->m_pendingIndex != GameObject::NotPending)
+		{
+			m_objectsToAdd[obj->m_pendingIndex].parent = parent ? parent->GetHandle() : GameObjectHandle();
+			return true;
+		}
+
+		// A just created object is not in the tree yet
+		std::unique_ptr<GameObject> holder = obj->IsInTree() ? Detach(obj) : std::unique_ptr<GameObject>(obj);
+
+		auto& siblings = parent ? parent->m_children : m_objects;
+		obj->m_indexInParent = siblings.size();
+		obj->m_parent = parent;
+		siblings.push_back(std::move(holder));
+		obj->MarkWorldTransformDirty();
+		return true;
+	}
+
+	std::unique_ptr<GameObject> Scene::Detach(GameObject* obj)
+	{
+		// Swap with the last sibling, so the removal does not shift the others
+		auto& siblings = obj->m_parent ? obj->m_parent->m_children : m_objects;
+		const size_t index = obj->m_indexInParent;
+		std::unique_ptr<GameObject> holder = std::move(siblings[index]);
+		if (index + 1 != siblings.size())
+		{
+			siblings[index] = std::move(siblings.back());
+			siblings[index]->m_indexInParent = index;
+		}
+		siblings.pop_back();
+
+		obj->m_indexInParent = GameObject::NotInTree;
+		obj->m_parent = nullptr;
+		return holder;
 	}
 
 	void Scene::SetMainCamera(GameObject* camera)
 	{
-		m_mainCamera = camera;
+		m_mainCamera = camera ? camera->GetHandle() : GameObjectHandle();
 	}
 
 	GameObject* Scene::GetMainCamera()
 	{
-		return m_mainCamera;
+		return Resolve(m_mainCamera);
 	}
 
-	std::vector<LightData> Scene::CollectLights()
+	void Scene::RegisterLight(LightComponent* light)
 	{
-		std::vector<LightData> lights;
-		for (auto& obj : m_objects)
+		if (std::find(m_lights.begin(), m_lights.end(), light) == m_lights.end())
+		{
+			m_lights.push_back(light);
+		}
+	}
+
+	void Scene::UnregisterLight(LightComponent* light)
+	{
+		auto it = std::find(m_lights.begin(), m_lights.end(), light);
+		if (it != m_lights.end())
+		{
+			*it = m_lights.back();
+			m_lights.pop_back();
+		}
+	}
+
+	void Scene::UnregisterLights(const std::vector<LightComponent*>& lights)
+	{
+		if (lights.empty())
+		{
+			return;
+		}
+
+		// Lights of this scene keep m_scene set, clearing it marks the ones to drop
+		for (auto light : lights)
+		{
+			if (light->m_scene == this)
+			{
+				light->m_scene = nullptr;
+			}
+		}
+		m_lights.erase(std::remove_if(m_lights.begin(), m_lights.end(), [](LightComponent* light) { return !light->m_scene; }), m_lights.end());
+	}
+
+	const std::vector<LightData>& Scene::CollectLights()
+	{
+		m_lightData.clear();
+		for (auto light : m_lights)
 		{
-			CollectLightsRecursive(obj.get(), lights);
+			// Skip lights under an inactive or destroyed object
+			bool active = true;
+			for (auto obj = light->GetOwner(); obj; obj = obj->GetParent())
+			{
+				if (!obj->IsActive() || !obj->IsAlive())
+				{
+					active = false;
+					break;
+				}
+			}
+			if (!active)
+			{
+				continue;
+			}
+
+			LightData data;
+			data.type = light->GetType();
+			data.color = light->GetColor();
+			data.radius = light->GetRadius();
+			data.position = light->GetOwner()->GetWorldPosition();
+			m_lightData.push_back(data);
 		}
-		return lights;
+		return m_lightData;
 	}
 
 	std::shared_ptr<Scene> Scene::Load(const std::string& path)
 	{
+		PROFILE_SCOPE("Scene::Load");
+
 		const std::string contents = Engine::GetInstance().GetFileSystem().LoadAssetFileText(path);
 		if (contents.empty())
 		{
@@ -254,6 +639,13 @@ namespace eng
 		}
 
 		auto json = nlohmann::json::parse(contents);
+		return LoadFromJson(json);
+	}
+
+	std::shared_ptr<Scene> Scene::LoadFromJson(const nlohmann::json& json)
+	{
+		PROFILE_SCOPE("Scene::LoadFromJson");
+
 		if (json.empty())
 		{
 			return nullptr;
@@ -262,6 +654,7 @@ namespace eng
 		auto result = std::make_shared<Scene>();
 
 		const std::string sceneName = json.value("name", "noname");
+		result->SetParallelUpdateEnabled(json.value("parallelUpdate", false));
 
 		if (json.contains("objects") && json["objects"].is_array())
 		{
@@ -289,23 +682,7 @@ namespace eng
 		return result;
 	}
 
-	void Scene::CollectLightsRecursive(GameObject* obj, std::vector<LightData>& out)
-	{
-		if (auto light = obj->GetComponent<LightComponent>())
-		{
-			LightData data;
-			data.color = light->GetColor();
-			data.position = obj->GetWorldPosition();
-			out.push_back(data);
-		}
-
-		for (auto& child : obj->m_children)
-		{
-			CollectLightsRecursive(child.get(), out);
-		}
-	}
-
-	void Scene::LoadObject(const nlohmann::json& jsonObject, GameObject* parent)
+	GameObject* Scene::LoadObject(const nlohmann::json& jsonObject, GameObject* parent)
 	{
 		const std::string name = jsonObject.value("name", "Object");
 
@@ -336,7 +713,7 @@ namespace eng
 
 		if (!gameObject)
 		{
-			return;
+			return nullptr;
 		}
 
 		// Position
@@ -399,5 +776,6 @@ namespace eng
 			}
 		}
 		gameObject->Init();
+		return gameObject;
 	}
 }
\ No newline at end of file
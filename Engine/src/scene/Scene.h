@@ -1,12 +1,19 @@
 #pragma once
 #include "GameObject.h"
+#include "scene/SceneSystem.h"
+#include "scene/Prefab.h"
 #include "Common.h"
 #include <string>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 
 namespace eng
 {
+	class LightComponent;
+	class RigidBody;
+	class Audio;
+
 	class Scene
 	{
 	public:
@@ -21,36 +28,128 @@ namespace eng
 		T* CreateObject(const std::string& name, GameObject* parent = nullptr)
 		{
 			auto obj = new T();
-			obj->SetName(name);
-			obj->m_scene = this;
-			if (m_isUpdating)
-			{
-				m_objectsToAdd.push_back({ obj, parent });
-			}
-			else
-			{
-				SetParent(obj, parent);
-			}
+			AddObject(obj, name, parent);
 			return obj;
 		}
 
+		// Reuses an instance of the prefab destroyed earlier if there is one, otherwise builds a new one.
+		// The position and rotation are local to the parent. OnSpawn runs once the instance is in the tree,
+		// during Update it may wait for the start of the next one.
+		GameObject* Instantiate(const std::shared_ptr<Prefab>& prefab, const glm::vec3& position,
+			const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f), GameObject* parent = nullptr);
+
+		// Null for an invalid or stale handle and for objects marked for destroy
+		GameObject* Resolve(GameObjectHandle handle) const;
+
+		// Constant time, the object goes last among its new siblings and its old last sibling takes its place
 		bool SetParent(GameObject* obj, GameObject* parent);
 
 		void SetMainCamera(GameObject* camera);
 		GameObject* GetMainCamera();
 
-		std::vector<LightData> CollectLights();
+		// Lights register themselves, collecting only visits the registered ones
+		void RegisterLight(LightComponent* light);
+		void UnregisterLight(LightComponent* light);
+		// One pass over the registry for any number of lights
+		void UnregisterLights(const std::vector<LightComponent*>& lights);
+		const std::vector<LightData>& CollectLights();
+
+		// Opt-in: components that have a system are updated by it in batches on the job system after
+		// the object tree walk, everything else still updates in tree order on the main thread.
+		// Enabling adds the default systems if none were added.
+		void SetParallelUpdateEnabled(bool enabled);
+		bool IsParallelUpdateEnabled() const;
+		// Systems run in the order added, consecutive ones that do not conflict run together
+		void AddSystem(std::unique_ptr<SceneSystem> system);
+		// True if a system updates the component after the tree walk instead of its owner
+		bool IsUpdatedBySystem(const Component* component) const;
+		// Every component of the type in the scene, dense and in no particular order
+		const std::vector<Component*>& GetComponents(size_t typeId) const;
+		// Whether the tree walk of the current Update reached the object, systems skip the components of the others
+		bool IsUpdatedThisFrame(const GameObject* obj) const;
+		// Rebuilds the stale world matrices of every object, one job per root object
+		void UpdateWorldTransforms(JobSystem& jobSystem);
 
 		static std::shared_ptr<Scene> Load(const std::string& path);
+		// Same as Load for an already parsed scene description
+		static std::shared_ptr<Scene> LoadFromJson(const nlohmann::json& json);
 
 	private:
-		void CollectLightsRecursive(GameObject* obj, std::vector<LightData>& out);
-		void LoadObject(const nlohmann::json& jsonObject, GameObject* parent);
+		// Names the object, gives it a handle and puts it in the tree, deferred while updating
+		void AddObject(GameObject* obj, const std::string& name, GameObject* parent);
+		void AssignHandle(GameObject* obj);
+		// Handles for an object and its whole subtree, for pooled instances
+		void AssignHandles(GameObject* obj);
+		// Puts an object with a handle into the tree, deferred while updating
+		void InsertObject(std::unique_ptr<GameObject> obj, GameObject* parent);
+		GameObject* BuildInstance(const Prefab& prefab, GameObject* parent);
+		void ReleaseHandle(GameObjectHandle handle);
+		// Takes the object out of its sibling list in constant time, the order of siblings changes
+		std::unique_ptr<GameObject> Detach(GameObject* obj);
+		GameObject* LoadObject(const nlohmann::json& jsonObject, GameObject* parent);
+		void RunSystems(float deltaTime);
+		// Destroys the queued objects, their bodies, voices and lights are released in one batch each
+		void FlushDestroyQueue();
+		// Swap-remove keeps the per-type lists dense, the index lives on the component
+		void RegisterComponent(Component* component);
+		void UnregisterComponent(Component* component);
+		// Components added before the object joined the scene, later ones register through AddComponent
+		void RegisterComponents(GameObject* obj);
 
 	private:
+		// Declared before m_objects so it is still alive while their components are destroyed
+		std::vector<LightComponent*> m_lights;
+		std::vector<LightData> m_lightData;
+		// Indexed by component type id, declared before the objects whose components unregister on destruction
+		std::vector<std::vector<Component*>> m_componentsByType;
+		// Bumped by every Update, objects the tree walk reaches take the current value
+		uint64_t m_updateFrame = 0;
+
+		struct ObjectSlot
+		{
+			GameObject* object = nullptr;
+			uint32_t generation = 0;
+		};
+		// Handle table, declared before the objects that release their slots on destruction
+		std::vector<ObjectSlot> m_objectSlots;
+		std::vector<uint32_t> m_freeObjectSlots;
+
 		std::vector<std::unique_ptr<GameObject>> m_objects;
-		std::vector<std::pair<GameObject*, GameObject*>> m_objectsToAdd;
-		GameObject* m_mainCamera = nullptr;
+		// Objects created during Update and the parent they go to once it is over
+		struct PendingObject
+		{
+			std::unique_ptr<GameObject> object;
+			GameObjectHandle parent;
+			// Prefab instance whose OnSpawn waits for the whole subtree to be attached
+			bool spawn = false;
+		};
+		std::vector<PendingObject> m_objectsToAdd;
+		std::vector<GameObject*> m_pendingSpawns;
+		// Dead objects already out of the tree, destroyed together at the end of Update
+		std::vector<std::unique_ptr<GameObject>> m_destroyQueue;
+
+		// Destroyed prefab instances waiting for reuse, out of the tree and with no handles in the subtree
+		struct PrefabPool
+		{
+			std::shared_ptr<Prefab> prefab;
+			std::vector<std::unique_ptr<GameObject>> objects;
+		};
+		std::unordered_map<const Prefab*, PrefabPool> m_prefabPools;
+
+		// Scratch lists of FlushDestroyQueue, kept so their memory is reused every frame
+		std::vector<std::pair<GameObject*, bool>> m_flushStack;
+		std::vector<RigidBody*> m_releasedBodies;
+		std::vector<std::shared_ptr<Audio>> m_releasedClips;
+		std::vector<LightComponent*> m_releasedLights;
+		GameObjectHandle m_mainCamera;
 		bool m_isUpdating = false;
+
+		bool m_parallelUpdate = false;
+		std::vector<std::unique_ptr<SceneSystem>> m_systems;
+		// Indexed by component type id
+		std::vector<SceneSystem*> m_systemByTypeId;
+		std::vector<std::vector<SceneSystem*>> m_systemPhases;
+
+		friend class GameObject;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,53 @@
+#include "scene/SceneSystem.h"
+#include "scene/Scene.h"
+#include "scene/GameObject.h"
+#include "profiling/Profiler.h"
+
+namespace eng
+{
+	bool SystemAccess::ConflictsWith(const SystemAccess& other) const
+	{
+		return (writes & (other.reads | other.writes)) != 0 || (reads & other.writes) != 0;
+	}
+
+	SceneSystem::SceneSystem(const char* name, SystemAccess access)
+		: m_name(name), m_access(access)
+	{
+	}
+
+	const char* SceneSystem::GetName() const
+	{
+		return m_name;
+	}
+
+	const SystemAccess& SceneSystem::GetAccess() const
+	{
+		return m_access;
+	}
+
+	size_t SceneSystem::GetComponentTypeId() const
+	{
+		return NoComponentType;
+	}
+
+	void SceneSystem::Run(Scene& scene, JobSystem& jobSystem, float deltaTime)
+	{
+		PROFILE_SCOPE(m_name);
+
+		// One pass over the dense list instead of collecting pointers during the tree walk
+		const size_t typeId = GetComponentTypeId();
+		if (typeId != NoComponentType)
+		{
+			for (auto component : scene.GetComponents(typeId))
+			{
+				if (scene.IsUpdatedThisFrame(component->GetOwner()))
+				{
+					m_components.push_back(component);
+				}
+			}
+		}
+
+		Update(scene, jobSystem, deltaTime);
+		m_components.clear();
+	}
+}
\ No newline at end of file
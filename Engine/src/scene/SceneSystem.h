@@ -0,0 +1,104 @@
+#pragma once
+#include "scene/Component.h"
+#include "jobs/JobSystem.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace eng
+{
+	class Scene;
+
+	// Data a system touches, systems whose accesses do not conflict run at the same time
+	enum SystemData : uint32_t
+	{
+		SystemDataNone = 0,
+		// Position, rotation and scale of objects
+		SystemDataLocalTransform = 1 << 0,
+		// Cached world matrices
+		SystemDataWorldTransform = 1 << 1,
+		SystemDataRenderQueue = 1 << 2,
+		SystemDataPhysicsBodies = 1 << 3,
+		SystemDataAudioSources = 1 << 4
+	};
+
+	struct SystemAccess
+	{
+		uint32_t reads = SystemDataNone;
+		uint32_t writes = SystemDataNone;
+
+		bool ConflictsWith(const SystemAccess& other) const;
+	};
+
+	// A batch step of Scene::Update when parallel update is enabled. Component systems get the
+	// components of their type that the object tree walk would have updated this frame.
+	class SceneSystem
+	{
+	public:
+		static constexpr size_t NoComponentType = std::numeric_limits<size_t>::max();
+
+		SceneSystem(const char* name, SystemAccess access);
+		virtual ~SceneSystem() = default;
+
+		const char* GetName() const;
+		const SystemAccess& GetAccess() const;
+		// Type id of the components routed to this system, NoComponentType for none
+		virtual size_t GetComponentTypeId() const;
+
+		void Run(Scene& scene, JobSystem& jobSystem, float deltaTime);
+
+	protected:
+		// For component systems m_components holds the scene's components of the type whose owner the
+		// tree walk reached this frame, in the order of the scene's dense list. Cleared after the update.
+		virtual void Update(Scene& scene, JobSystem& jobSystem, float deltaTime) = 0;
+
+	protected:
+		std::vector<Component*> m_components;
+
+	private:
+		const char* m_name;
+		SystemAccess m_access;
+	};
+
+	// Updates components of type T in batches. Without Parallel the batches run on one thread,
+	// for updates that are only safe against other systems but not against each other.
+	template<typename T, bool Parallel = true>
+	class ComponentSystem : public SceneSystem
+	{
+	public:
+		static constexpr size_t MinBatchSize = 64;
+
+		using SceneSystem::SceneSystem;
+
+		size_t GetComponentTypeId() const override
+		{
+			return T::TypeId();
+		}
+
+	protected:
+		void Update(Scene& scene, JobSystem& jobSystem, float deltaTime) override
+		{
+			if (!Parallel)
+			{
+				UpdateBatch(m_components.data(), m_components.data() + m_components.size(), deltaTime);
+				return;
+			}
+
+			Component* const* components = m_components.data();
+			jobSystem.ParallelFor(m_components.size(), MinBatchSize, [this, components, deltaTime](size_t begin, size_t end)
+				{
+					UpdateBatch(components + begin, components + end, deltaTime);
+				});
+		}
+
+		// Called for [begin, end) of the queued components, may run concurrently with other batches when Parallel
+		virtual void UpdateBatch(Component* const* begin, Component* const* end, float deltaTime)
+		{
+			for (auto it = begin; it != end; ++it)
+			{
+				static_cast<T*>(*it)->Update(deltaTime);
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "AnimationComponent.h"
 #include "scene/GameObject.h"
+#include "scene/Scene.h"
 
 namespace eng
 {
@@ -31,11 +32,16 @@ namespace eng
 			}
 		}
 
+		auto scene = m_owner->GetScene();
 		for (auto& binding : m_bindings)
 		{
-			auto& obj = binding.first;
-			auto& trackIndices = binding.second->trackIndices;
-			for (auto i : trackIndices)
+			auto obj = scene->Resolve(binding.object);
+			if (!obj)
+			{
+				continue;
+			}
+
+			for (auto i : binding.trackIndices)
 			{
 				auto& track = m_clip->tracks[i];
 				if (!track.positions.empty())
@@ -57,6 +63,11 @@ namespace eng
 		}
 	}
 
+	void AnimationComponent::OnSpawn()
+	{
+		BuildBindings();
+	}
+
 	void AnimationComponent::SetClip(AnimationClip* clip)
 	{
 		m_clip = clip;
@@ -102,23 +113,26 @@ namespace eng
 			return;
 		}
 
+		// Binding index per object, so tracks of the same object share a binding
+		std::unordered_map<GameObject*, size_t> bindingIndices;
 		for (size_t i = 0; i < m_clip->tracks.size(); ++i)
 		{
 			auto& track = m_clip->tracks[i];
 			auto targetObject = m_owner->FindChildByName(track.targetName);
 			if (targetObject)
 			{
-				auto it = m_bindings.find(targetObject);
-				if (it != m_bindings.end())
+				auto it = bindingIndices.find(targetObject);
+				if (it != bindingIndices.end())
 				{
-					it->second->trackIndices.push_back(i);
+					m_bindings[it->second].trackIndices.push_back(i);
 				}
 				else
 				{
-					auto binding = std::make_unique<ObjectBinding>();
-					binding->object = targetObject;
-					binding->trackIndices.push_back(i);
-					m_bindings.emplace(targetObject, std::move(binding));
+					bindingIndices.emplace(targetObject, m_bindings.size());
+					ObjectBinding binding;
+					binding.object = targetObject->GetHandle();
+					binding.trackIndices.push_back(i);
+					m_bindings.push_back(std::move(binding));
 				}
 			}
 		}
@@ -1,5 +1,6 @@
 #pragma once
 #include "scene/Component.h"
+#include "scene/GameObjectHandle.h"
 #include <glm/vec3.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <string>
@@ -39,7 +40,7 @@ namespace eng
 
 	struct ObjectBinding
 	{
-		GameObject* object = nullptr;
+		GameObjectHandle object;
 		std::vector<size_t> trackIndices;
 	};
 
@@ -49,6 +50,8 @@ namespace eng
 
 	public:
 		void Update(float deltaTime) override;
+		// Bindings hold handles, a reused prefab instance has new ones
+		void OnSpawn() override;
 		void SetClip(AnimationClip* clip);
 		void RegisterClip(const std::string& name, const std::shared_ptr<AnimationClip>& clip);
 		void Play(const std::string& name, bool loop = true);
@@ -67,6 +70,7 @@ namespace eng
 		bool m_isPlaying = false;
 
 		std::unordered_map<std::string, std::shared_ptr<AnimationClip>> m_clips;
-		std::unordered_map<GameObject*, std::unique_ptr<ObjectBinding>> m_bindings;
+		// Bound objects that were destroyed since are skipped
+		std::vector<ObjectBinding> m_bindings;
 	};
 }
\ No newline at end of file
@@ -77,4 +77,16 @@ namespace eng
 
 		return false;
 	}
+
+	void AudioComponent::ReleaseClips(std::vector<std::shared_ptr<Audio>>& released)
+	{
+		for (auto& clip : m_clips)
+		{
+			if (clip.second)
+			{
+				released.push_back(std::move(clip.second));
+			}
+		}
+		m_clips.clear();
+	}
 }
\ No newline at end of file
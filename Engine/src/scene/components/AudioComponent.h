@@ -15,6 +15,8 @@ namespace eng
 		void Play(const std::string& name, bool loop = false);
 		void Stop(const std::string& name);
 		bool IsPlaying(const std::string& name);
+		// Hands the clips over so a batch of destroyed objects releases its voices together
+		void ReleaseClips(std::vector<std::shared_ptr<Audio>>& released);
 
 	private:
 		std::unordered_map<std::string, std::shared_ptr<Audio>> m_clips;
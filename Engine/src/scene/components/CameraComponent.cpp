@@ -28,4 +28,14 @@ namespace eng
 	{
 		return glm::perspective(glm::radians(m_fov), aspect, m_nearPlane, m_farPlane);
 	}
+
+	float CameraComponent::GetNearPlane() const
+	{
+		return m_nearPlane;
+	}
+
+	float CameraComponent::GetFarPlane() const
+	{
+		return m_farPlane;
+	}
 }
\ No newline at end of file
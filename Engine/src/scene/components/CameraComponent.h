@@ -12,6 +12,8 @@ namespace eng
 
 		glm::mat4 GetViewMatrix() const;
 		glm::mat4 GetProjectionMatrix(float aspect) const;
+		float GetNearPlane() const;
+		float GetFarPlane() const;
 
 	private:
 		float m_fov = 60.0f;
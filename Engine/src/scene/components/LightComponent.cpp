@@ -1,7 +1,31 @@
 #include "scene/components/LightComponent.h"
+#include "scene/GameObject.h"
+#include "scene/Scene.h"
 
 namespace eng
 {
+	LightComponent::~LightComponent()
+	{
+		if (m_scene)
+		{
+			m_scene->UnregisterLight(this);
+		}
+	}
+
+	void LightComponent::Init()
+	{
+		if (m_scene)
+		{
+			return;
+		}
+
+		m_scene = m_owner->GetScene();
+		if (m_scene)
+		{
+			m_scene->RegisterLight(this);
+		}
+	}
+
 	void LightComponent:: LoadProperties(const nlohmann::json& json)
 	{
 		if (json.contains("color"))
@@ -14,6 +38,18 @@ namespace eng
 			);
 			SetColor(color);
 		}
+
+		const std::string type = json.value("lightType", "directional");
+		if (type == "point")
+		{
+			SetType(LightType::Point);
+		}
+		else
+		{
+			SetType(LightType::Directional);
+		}
+
+		SetRadius(json.value("radius", m_radius));
 	}
 
 	void LightComponent::Update(float deltaTime)
@@ -29,4 +65,24 @@ namespace eng
 	{
 		return m_color;
 	}
+
+	void LightComponent::SetType(LightType type)
+	{
+		m_type = type;
+	}
+
+	LightType LightComponent::GetType() const
+	{
+		return m_type;
+	}
+
+	void LightComponent::SetRadius(float radius)
+	{
+		m_radius = radius;
+	}
+
+	float LightComponent::GetRadius() const
+	{
+		return m_radius;
+	}
 }
\ No newline at end of file
@@ -1,20 +1,36 @@
 #pragma once
 #include "scene/Component.h"
+#include "Common.h"
 #include <glm/vec3.hpp>
 
 namespace eng
 {
+	class Scene;
+
 	class LightComponent : public Component
 	{
 		COMPONENT(LightComponent)
 	public:
+		~LightComponent() override;
+
+		void Init() override;
 		void LoadProperties(const nlohmann::json& json) override;
 		void Update(float deltaTime) override;
 
 		void SetColor(const glm::vec3& color);
 		const glm::vec3& GetColor() const;
+		void SetType(LightType type);
+		LightType GetType() const;
+		void SetRadius(float radius);
+		float GetRadius() const;
 
 	private:
 		glm::vec3 m_color = glm::vec3(1.0f);
+		LightType m_type = LightType::Directional;
+		float m_radius = 10.0f;
+		// Scene this light is registered with
+		Scene* m_scene = nullptr;
+
+		friend class Scene;
 	};
 }
@@ -18,9 +18,11 @@ namespace eng
 		{
 			auto& matObj = json["material"];
 			const std::string path = matObj.value("path", "");
-			auto mat = Material::Load(path);
+			auto mat = Engine::GetInstance().GetMaterialManager().GetOrLoadMaterial(path);
 			if (mat && matObj.contains("params"))
 			{
+				// Overrides go to an instance, the loaded material is shared with every other user of the file
+				mat = Material::CreateInstance(mat);
 				auto& paramsObj = matObj["params"];
 
 				// Floats
@@ -66,7 +68,7 @@ namespace eng
 					{
 						std::string name = p.value("name", "");
 						std::string texPath = p.value("path", "");
-						auto texture = Texture::Load(texPath);
+						auto texture = Engine::GetInstance().GetTextureManager().GetOrLoadTexture(texPath);
 
 						mat->SetParam(name, texture);
 					}
@@ -99,20 +101,29 @@ namespace eng
 
 	void MeshComponent::Update(float deltaTime)
 	{
-		if (!m_material || !m_mesh)
+		RenderCommand command;
+		if (!BuildRenderCommand(command))
 		{
 			return;
 		}
 
-		RenderCommand command;
-		command.material = m_material.get();
-		command.mesh = m_mesh.get();
-		command.modelMatrix = GetOwner()->GetWorldTransform();
-
 		auto& renderQueue = Engine::GetInstance().GetRenderQueue();
 		renderQueue.Submit(command);
 	}
 
+	bool MeshComponent::BuildRenderCommand(RenderCommand& command) const
+	{
+		if (!m_material || !m_mesh)
+		{
+			return false;
+		}
+
+		command.material = m_material.get();
+		command.mesh = m_mesh.get();
+		command.modelMatrix = m_owner->GetWorldTransform();
+		return true;
+	}
+
 	void MeshComponent::SetMaterial(const std::shared_ptr<Material>& material)
 	{
 		m_material = material;
@@ -6,6 +6,7 @@ namespace eng
 {
 	class Material;
 	class Mesh;
+	struct RenderCommand;
 
 	class MeshComponent : public Component
 	{
@@ -15,6 +16,8 @@ namespace eng
 		MeshComponent(const std::shared_ptr<Material>& material, const std::shared_ptr<Mesh>& mesh);
 		void LoadProperties(const nlohmann::json& json) override;
 		void Update(float deltaTime) override;
+		// Fills the command Update would submit, false when there is nothing to draw
+		bool BuildRenderCommand(RenderCommand& command) const;
 
 		void SetMaterial(const std::shared_ptr<Material>& material);
 		void SetMesh(const std::shared_ptr<Mesh>& mesh);
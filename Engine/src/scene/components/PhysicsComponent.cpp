@@ -89,6 +89,23 @@ namespace eng
         Engine::GetInstance().GetPhysicsManager().AddRigidBody(m_rigidBody.get());
     }
 
+    void PhysicsComponent::OnSpawn()
+    {
+        if (!m_rigidBody)
+        {
+            return;
+        }
+
+        m_rigidBody->SetPosition(m_owner->GetWorldPosition());
+        m_rigidBody->SetRotation(m_owner->GetWorldRotation());
+        m_rigidBody->ResetMotion();
+
+        if (!m_rigidBody->IsAddedToWorld())
+        {
+            Engine::GetInstance().GetPhysicsManager().AddRigidBody(m_rigidBody.get());
+        }
+    }
+
     void PhysicsComponent::Update(float deltaTime)
     {
         if (!m_rigidBody)
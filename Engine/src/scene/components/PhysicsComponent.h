@@ -13,6 +13,8 @@ namespace eng
 
         void LoadProperties(const nlohmann::json& json) override;
         void Init() override;
+        // Moves the body to the owner, stops it and puts it back into the world
+        void OnSpawn() override;
         void Update(float deltaTime) override;
 
         void SetRigidBody(const std::shared_ptr<RigidBody>& body);
@@ -0,0 +1,519 @@
+#include "eng.h"
+#include "graphics/NullGraphicsAPI.h"
+#include <json/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Runs the engine subsystems over a generated scene and prints the timings as JSON.
+//
+// EngineBench [--objects N] [--depth N] [--components N] [--lights N] [--frames N] [--warmup N]
+//             [--material path] [--gltf path] [--gltf-runs N] [--assets dir] [--output file] [--trace file] [--windowed]
+//             [--parallel] [--workers N] [--streaming]
+
+namespace
+{
+	struct BenchConfig
+	{
+		int objects = 1000;
+		// Objects are placed in chains of this length, 1 keeps every object at the root
+		int depth = 4;
+		// 0 - empty objects, 1 - mesh, 2 - mesh and dynamic rigid body
+		int components = 1;
+		int lights = 64;
+		int frames = 300;
+		int warmup = 10;
+		int gltfRuns = 5;
+		std::string material = "materials/brick.mat";
+		std::string gltf = "models/suzanne/Suzanne.gltf";
+		std::string assets;
+		std::string output;
+		// Chrome trace of the measured frames
+		std::string trace;
+		bool windowed = false;
+		// Scene systems on the job system instead of the object tree walk
+		bool parallel = false;
+		// 0 keeps the engine default of one worker per extra hardware thread
+		int workers = 0;
+		// Texture mips streamed by on-screen size
+		bool streaming = false;
+	};
+
+	class BenchApplication : public eng::Application
+	{
+	public:
+		bool Init() override { return true; }
+		void Update(float deltaTime) override {}
+		void Destroy() override {}
+	};
+
+	using Clock = std::chrono::steady_clock;
+
+	double ElapsedMs(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	nlohmann::json Summarize(std::vector<double> samples)
+	{
+		nlohmann::json result;
+		result["samples"] = samples.size();
+		if (samples.empty())
+		{
+			return result;
+		}
+
+		std::sort(samples.begin(), samples.end());
+		double total = 0.0;
+		for (double sample : samples)
+		{
+			total += sample;
+		}
+
+		auto percentile = [&samples](double p)
+			{
+				size_t index = static_cast<size_t>(p * static_cast<double>(samples.size() - 1) + 0.5);
+				return samples[index];
+			};
+
+		result["min_ms"] = samples.front();
+		result["mean_ms"] = total / static_cast<double>(samples.size());
+		result["median_ms"] = percentile(0.5);
+		result["p95_ms"] = percentile(0.95);
+		result["max_ms"] = samples.back();
+		result["total_ms"] = total;
+		return result;
+	}
+
+	bool ParseArgs(int argc, char** argv, BenchConfig& config)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const char* arg = argv[i];
+			const bool hasValue = i + 1 < argc;
+
+			if (std::strcmp(arg, "--windowed") == 0)
+			{
+				config.windowed = true;
+			}
+			else if (std::strcmp(arg, "--parallel") == 0)
+			{
+				config.parallel = true;
+			}
+			else if (std::strcmp(arg, "--streaming") == 0)
+			{
+				config.streaming = true;
+			}
+			else if (hasValue && std::strcmp(arg, "--workers") == 0)
+			{
+				config.workers = std::max(0, std::atoi(argv[++i]));
+			}
+			else if (hasValue && std::strcmp(arg, "--objects") == 0)
+			{
+				config.objects = std::max(0, std::atoi(argv[++i]));
+			}
+			else if (hasValue && std::strcmp(arg, "--depth") == 0)
+			{
+				config.depth = std::max(1, std::atoi(argv[++i]));
+			}
+			else if (hasValue && std::strcmp(arg, "--components") == 0)
+			{
+				config.components = std::clamp(std::atoi(argv[++i]), 0, 2);
+			}
+			else if (hasValue && std::strcmp(arg, "--lights") == 0)
+			{
+				config.lights = std::max(0, std::atoi(argv[++i]));
+			}
+			else if (hasValue && std::strcmp(arg, "--frames") == 0)
+			{
+				config.frames = std::max(1, std::atoi(argv[++i]));
+			}
+			else if (hasValue && std::strcmp(arg, "--warmup") == 0)
+			{
+				config.warmup = std::max(0, std::atoi(argv[++i]));
+			}
+			else if (hasValue && std::strcmp(arg, "--gltf-runs") == 0)
+			{
+				config.gltfRuns = std::max(0, std::atoi(argv[++i]));
+			}
+			else if (hasValue && std::strcmp(arg, "--material") == 0)
+			{
+				config.material = argv[++i];
+			}
+			else if (hasValue && std::strcmp(arg, "--gltf") == 0)
+			{
+				config.gltf = argv[++i];
+			}
+			else if (hasValue && std::strcmp(arg, "--assets") == 0)
+			{
+				config.assets = argv[++i];
+			}
+			else if (hasValue && std::strcmp(arg, "--output") == 0)
+			{
+				config.output = argv[++i];
+			}
+			else if (hasValue && std::strcmp(arg, "--trace") == 0)
+			{
+				config.trace = argv[++i];
+			}
+			else
+			{
+				std::cerr << "Unknown argument: " << arg << std::endl;
+				return false;
+			}
+		}
+		return true;
+	}
+
+	nlohmann::json MakeObject(const BenchConfig& config, int index, bool isRoot)
+	{
+		nlohmann::json object;
+		object["name"] = "Object" + std::to_string(index);
+
+		// Roots are spread on a grid, children are offset from their parent
+		const int gridSize = 32;
+		const float spacing = 3.0f;
+		if (isRoot)
+		{
+			object["position"] = {
+				{ "x", static_cast<float>(index % gridSize) * spacing },
+				{ "y", 0.0f },
+				{ "z", -static_cast<float>((index / gridSize) % gridSize) * spacing }
+			};
+		}
+		else
+		{
+			object["position"] = { { "x", 0.0f }, { "y", 1.5f }, { "z", 0.0f } };
+		}
+
+		auto components = nlohmann::json::array();
+		if (config.components >= 1)
+		{
+			components.push_back({
+				{ "type", "MeshComponent" },
+				{ "material", { { "path", config.material } } },
+				{ "mesh", { { "type", "box" }, { "x", 1.0f }, { "y", 1.0f }, { "z", 1.0f } } }
+			});
+		}
+		if (config.components >= 2)
+		{
+			components.push_back({
+				{ "type", "PhysicsComponent" },
+				{ "collider", { { "type", "box" }, { "x", 1.0f }, { "y", 1.0f }, { "z", 1.0f } } },
+				{ "body", { { "mass", 1.0f }, { "friction", 0.5f }, { "type", "dynamic" } } }
+			});
+		}
+		object["components"] = components;
+		object["children"] = nlohmann::json::array();
+		return object;
+	}
+
+	nlohmann::json GenerateScene(const BenchConfig& config)
+	{
+		nlohmann::json scene;
+		scene["name"] = "bench";
+		auto objects = nlohmann::json::array();
+
+		// Chains of config.depth objects, built bottom up
+		for (int index = 0; index < config.objects; index += config.depth)
+		{
+			const int chainLength = std::min(config.depth, config.objects - index);
+			nlohmann::json chain = MakeObject(config, index + chainLength - 1, chainLength == 1);
+			for (int level = chainLength - 2; level >= 0; --level)
+			{
+				nlohmann::json parent = MakeObject(config, index + level, level == 0);
+				parent["children"].push_back(std::move(chain));
+				chain = std::move(parent);
+			}
+			objects.push_back(std::move(chain));
+		}
+
+		objects.push_back({
+			{ "name", "Sun" },
+			{ "position", { { "x", 10.0f }, { "y", 20.0f }, { "z", 10.0f } } },
+			{ "components", { { { "type", "LightComponent" } } } }
+		});
+
+		for (int i = 0; i < config.lights; ++i)
+		{
+			objects.push_back({
+				{ "name", "Light" + std::to_string(i) },
+				{ "position", { { "x", static_cast<float>(i % 16) * 6.0f }, { "y", 2.0f }, { "z", -static_cast<float>(i / 16) * 6.0f } } },
+				{ "components", { {
+					{ "type", "LightComponent" },
+					{ "lightType", "point" },
+					{ "radius", 8.0f },
+					{ "color", { { "r", 1.0f }, { "g", 0.8f }, { "b", 0.6f } } }
+				} } }
+			});
+		}
+
+		objects.push_back({
+			{ "name", "Camera" },
+			{ "position", { { "x", 48.0f }, { "y", 30.0f }, { "z", 40.0f } } },
+			{ "rotation", { { "x", -0.2588f }, { "y", 0.0f }, { "z", 0.0f }, { "w", 0.9659f } } },
+			{ "components", { { { "type", "CameraComponent" } } } }
+		});
+
+		scene["objects"] = objects;
+		scene["camera"] = "Camera";
+		scene["parallelUpdate"] = config.parallel;
+		return scene;
+	}
+
+	eng::CameraData GetCameraData(eng::Scene& scene, float aspect, float viewportHeight)
+	{
+		eng::CameraData cameraData;
+		cameraData.viewportHeight = viewportHeight;
+		if (auto cameraObject = scene.GetMainCamera())
+		{
+			if (auto cameraComponent = cameraObject->GetComponent<eng::CameraComponent>())
+			{
+				cameraData.viewMatrix = cameraComponent->GetViewMatrix();
+				cameraData.projectionMatrix = cameraComponent->GetProjectionMatrix(aspect);
+				cameraData.position = cameraObject->GetWorldPosition();
+				cameraData.nearPlane = cameraComponent->GetNearPlane();
+				cameraData.farPlane = cameraComponent->GetFarPlane();
+			}
+		}
+		return cameraData;
+	}
+
+	nlohmann::json RunBenchmarks(const BenchConfig& config)
+	{
+		auto& engine = eng::Engine::GetInstance();
+		auto& graphicsAPI = engine.GetGraphicsAPI();
+		auto& renderQueue = engine.GetRenderQueue();
+		auto& physicsManager = engine.GetPhysicsManager();
+		auto& textureManager = engine.GetTextureManager();
+
+		nlohmann::json results;
+
+		// Scene::Load without the file read, the text is generated in memory
+		const std::string sceneText = GenerateScene(config).dump();
+		auto loadStart = Clock::now();
+		auto scene = eng::Scene::LoadFromJson(nlohmann::json::parse(sceneText));
+		results["scene_load"] = Summarize({ ElapsedMs(loadStart) });
+
+		// Textures decode in the background, the frames below are measured with all of them uploaded
+		auto textureStart = Clock::now();
+		textureManager.FinishPendingLoads();
+		results["texture_finish"] = Summarize({ ElapsedMs(textureStart) });
+
+		if (!scene)
+		{
+			std::cerr << "Failed to load the generated scene" << std::endl;
+			return results;
+		}
+
+		const float deltaTime = 1.0f / 60.0f;
+		const float aspect = 1280.0f / 720.0f;
+		std::vector<double> updateSamples;
+		std::vector<double> physicsSamples;
+		std::vector<double> drawSamples;
+		std::vector<double> textureSamples;
+		std::vector<double> frameSamples;
+
+		for (int frame = 0; frame < config.warmup + config.frames; ++frame)
+		{
+			const bool measured = frame >= config.warmup;
+			if (frame == config.warmup && !config.trace.empty())
+			{
+				eng::Profiler::GetInstance().StartCapture(static_cast<uint32_t>(config.frames), config.trace);
+			}
+			eng::Profiler::GetInstance().BeginFrame();
+			PROFILE_SCOPE("EngineBench::Frame");
+			auto frameStart = Clock::now();
+
+			auto start = Clock::now();
+			physicsManager.Update(deltaTime);
+			const double physicsMs = ElapsedMs(start);
+
+			start = Clock::now();
+			scene->Update(deltaTime);
+			const double updateMs = ElapsedMs(start);
+
+			start = Clock::now();
+			graphicsAPI.ResetStats();
+			graphicsAPI.BeginGpuFrame();
+			graphicsAPI.ClearBuffers();
+			const auto cameraData = GetCameraData(*scene, aspect, 720.0f);
+			graphicsAPI.UpdateFrameUniforms(cameraData, scene->CollectLights());
+			renderQueue.Draw(graphicsAPI, cameraData);
+			const double drawMs = ElapsedMs(start);
+
+			// Uploads and, with --streaming, mip requests from the screen sizes Draw just reported
+			start = Clock::now();
+			textureManager.Update();
+			const double textureMs = ElapsedMs(start);
+
+			if (measured)
+			{
+				physicsSamples.push_back(physicsMs);
+				updateSamples.push_back(updateMs);
+				drawSamples.push_back(drawMs);
+				textureSamples.push_back(textureMs);
+				frameSamples.push_back(ElapsedMs(frameStart));
+			}
+		}
+
+		results["scene_update"] = Summarize(updateSamples);
+		results["physics_update"] = Summarize(physicsSamples);
+		results["render_queue_draw"] = Summarize(drawSamples);
+		results["texture_update"] = Summarize(textureSamples);
+		results["frame"] = Summarize(frameSamples);
+
+		// Counters of the last frame
+		const auto& renderStats = renderQueue.GetStats();
+		results["render_stats"] = {
+			{ "submitted", renderStats.submitted },
+			{ "culled", renderStats.culled },
+			{ "visible", renderStats.visible },
+			{ "shader_program_binds", renderStats.shaderProgramBinds },
+			{ "material_binds", renderStats.materialBinds },
+			{ "mesh_binds", renderStats.meshBinds },
+			{ "draw_calls", renderStats.drawCalls },
+			{ "instanced_draw_calls", renderStats.instancedDrawCalls },
+			{ "instanced_commands", renderStats.instancedCommands }
+		};
+		const auto& graphicsStats = graphicsAPI.GetStats();
+		results["graphics_stats"] = {
+			{ "issued_state_calls", graphicsStats.issuedStateCalls },
+			{ "skipped_state_calls", graphicsStats.skippedStateCalls }
+		};
+		// GPU time of the latest frame with results, only the OpenGL backend measures it
+		auto gpuPasses = nlohmann::json::object();
+		for (const auto& pass : graphicsAPI.GetGpuPassTimings())
+		{
+			gpuPasses[pass.name] = pass.milliseconds;
+		}
+		results["gpu_pass_ms"] = gpuPasses;
+		results["point_lights_binned"] = graphicsAPI.GetLightClusters().GetPointLightCount();
+		results["texture_stats"] = {
+			{ "streamed_bytes", textureManager.GetStreamedBytes() },
+			{ "pending", textureManager.GetPendingCount() }
+		};
+
+		// glTF import into a scratch scene
+		std::vector<double> gltfSamples;
+		if (!config.gltf.empty() && config.gltfRuns > 0)
+		{
+			eng::Scene gltfScene;
+			for (int run = 0; run < config.gltfRuns; ++run)
+			{
+				auto start = Clock::now();
+				auto object = eng::GameObject::LoadGLTF(config.gltf, &gltfScene);
+				const double ms = ElapsedMs(start);
+				if (!object)
+				{
+					std::cerr << "Failed to import " << config.gltf << std::endl;
+					break;
+				}
+				gltfSamples.push_back(ms);
+			}
+		}
+		results["gltf_import"] = Summarize(gltfSamples);
+
+		// Textures of the first import, later ones come from the cache
+		auto gltfTextureStart = Clock::now();
+		textureManager.FinishPendingLoads();
+		results["gltf_texture_finish"] = Summarize({ ElapsedMs(gltfTextureStart) });
+
+		return results;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchConfig config;
+	if (!ParseArgs(argc, argv, config))
+	{
+		return 1;
+	}
+
+	eng::Engine& engine = eng::Engine::GetInstance();
+	engine.SetApplication(new BenchApplication());
+
+	// Run from the project folder the bench reuses the game's assets
+	if (config.assets.empty() && !std::filesystem::exists("assets") && std::filesystem::exists("../MySoft/assets"))
+	{
+		config.assets = "../MySoft/assets";
+	}
+	if (!config.assets.empty())
+	{
+		engine.GetFileSystem().SetAssetsFolder(config.assets);
+	}
+
+	if (!engine.Init(1280, 720, !config.windowed))
+	{
+		std::cerr << "Failed to initialize the engine" << std::endl;
+		engine.Destroy();
+		return 1;
+	}
+
+	if (config.workers > 0)
+	{
+		engine.GetJobSystem().Shutdown();
+		engine.GetJobSystem().Init(static_cast<unsigned int>(config.workers));
+	}
+	engine.GetTextureManager().SetStreamingEnabled(config.streaming);
+
+	nlohmann::json report;
+	report["config"] = {
+		{ "objects", config.objects },
+		{ "depth", config.depth },
+		{ "components", config.components },
+		{ "lights", config.lights },
+		{ "frames", config.frames },
+		{ "warmup", config.warmup },
+		{ "material", config.material },
+		{ "gltf", config.gltf },
+		{ "backend", config.windowed ? "opengl" : "null" },
+		{ "parallel", config.parallel },
+		{ "streaming", config.streaming },
+		{ "workers", engine.GetJobSystem().GetWorkerCount() }
+	};
+#if defined (NDEBUG)
+	report["build"] = "release";
+#else
+	report["build"] = "debug";
+#endif
+	report["results"] = RunBenchmarks(config);
+
+	if (!config.windowed)
+	{
+		const auto& calls = static_cast<eng::NullGraphicsAPI&>(engine.GetGraphicsAPI()).GetRecordedCalls();
+		report["null_backend_calls"] = {
+			{ "shader_programs", calls.shaderPrograms },
+			{ "buffers", calls.buffers },
+			{ "buffer_uploads", calls.bufferUploads },
+			{ "vertex_arrays", calls.vertexArrays },
+			{ "textures", calls.textures },
+			{ "uniforms", calls.uniforms },
+			{ "state_changes", calls.stateChanges },
+			{ "frame_uploads", calls.frameUploads },
+			{ "draw_calls", calls.drawCalls },
+			{ "instanced_draw_calls", calls.instancedDrawCalls },
+			{ "instances", calls.instances }
+		};
+	}
+
+	const std::string text = report.dump(2);
+	if (config.output.empty())
+	{
+		std::cout << text << std::endl;
+	}
+	else
+	{
+		std::ofstream file(config.output);
+		file << text << std::endl;
+	}
+
+	engine.Destroy();
+	return 0;
+}
\ No newline at end of file
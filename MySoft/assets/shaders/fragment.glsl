@@ -6,8 +6,17 @@ struct Light
     vec3 direction;
 };
 
-uniform Light uLight;
-uniform vec3 uCameraPos;
+layout (std140) uniform FrameData
+{
+    mat4 uView;
+    mat4 uProjection;
+    vec3 uCameraPos;
+    int uLightCount;
+    uvec4 uClusterSize;
+    vec4 uClusterDepth;
+    Light uLights[MAX_LIGHTS];
+};
+
 uniform vec3 color;
 
 out vec4 FragColor;
@@ -17,29 +26,79 @@ in vec3 vNormal;
 in vec3 vFragPos;
 
 uniform sampler2D baseColorTexture;
+uniform usamplerBuffer uClusterGrid;
+uniform usamplerBuffer uClusterLightIndices;
+uniform samplerBuffer uPointLights;
 
-void main()
+vec3 ShadeLight(vec3 lightDir, vec3 lightColor, vec3 norm, vec3 viewDir)
 {
-    vec3 norm = normalize(vNormal);
-    
     // diffuse
-    vec3 lightDir = normalize(-uLight.direction);
     float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diff * uLight.color;
+    vec3 diffuse = diff * lightColor;
 
     // specular
-    vec3 viewDir = normalize(uCameraPos - vFragPos);
-    vec3 redlectDir = reflect(-lightDir, norm);
-    float spec = pow(max(dot(viewDir, redlectDir), 0.0), 32.0);
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0);
     float specularStrength = 0.5;
-    vec3 specular = specularStrength * spec * uLight.color;
+    vec3 specular = specularStrength * spec * lightColor;
+
+    return diffuse + specular;
+}
+
+int GetClusterIndex(vec3 fragPos)
+{
+    vec4 viewPos = uView * vec4(fragPos, 1.0);
+    vec4 clipPos = uProjection * viewPos;
+    vec2 cell = (clipPos.xy / clipPos.w * 0.5 + 0.5) * vec2(uClusterSize.xy);
+    float slice = log(max(-viewPos.z, uClusterDepth.x)) * uClusterDepth.z + uClusterDepth.w;
+    ivec3 cluster = clamp(ivec3(vec3(cell, slice)), ivec3(0), ivec3(uClusterSize.xyz) - 1);
+    return cluster.x + int(uClusterSize.x) * (cluster.y + int(uClusterSize.y) * cluster.z);
+}
+
+vec3 ShadeLights(vec3 norm, vec3 viewDir, vec3 fragPos)
+{
+    vec3 result = vec3(0.0);
+
+    for (int i = 0; i < uLightCount; ++i)
+    {
+        result += ShadeLight(normalize(-uLights[i].direction), uLights[i].color, norm, viewDir);
+    }
+
+    // only the point lights binned into this fragment's cluster
+    if (uClusterSize.w > 0u)
+    {
+        uvec2 range = texelFetch(uClusterGrid, GetClusterIndex(fragPos)).xy;
+        for (uint i = 0u; i < range.y; ++i)
+        {
+            int lightIndex = int(texelFetch(uClusterLightIndices, int(range.x + i)).x);
+            vec4 positionRadius = texelFetch(uPointLights, lightIndex * 2);
+            vec3 lightColor = texelFetch(uPointLights, lightIndex * 2 + 1).rgb;
+
+            vec3 toLight = positionRadius.xyz - fragPos;
+            float lightDistance = length(toLight);
+            float falloff = clamp(1.0 - pow(lightDistance / positionRadius.w, 4.0), 0.0, 1.0);
+            float attenuation = falloff * falloff / (lightDistance * lightDistance + 1.0);
+            result += ShadeLight(toLight / max(lightDistance, 0.0001), lightColor, norm, viewDir) * attenuation;
+        }
+    }
 
     // ambient
     const float ambientStrength = 0.4;
-    vec3 ambient = ambientStrength * uLight.color;
-    
+    vec3 ambientColor = uLightCount > 0 ? uLights[0].color : vec3(0.0);
+    result += ambientStrength * ambientColor;
+
+    return result;
+}
+
+void main()
+{
+    vec3 norm = normalize(vNormal);
+    vec3 viewDir = normalize(uCameraPos - vFragPos);
+
+    vec3 lighting = ShadeLights(norm, viewDir, vFragPos);
+
     vec4 texColor = texture(baseColorTexture, vUV);
-    vec3 result = (diffuse + specular + ambient) * texColor.xyz * color;
+    vec3 result = lighting * texColor.xyz * color;
 
     FragColor = vec4(result, 1.0);
 }
\ No newline at end of file
@@ -4,22 +4,46 @@ layout (location = 0) in vec3 position;
 layout (location = 1) in vec3 color;
 layout (location = 2) in vec2 uv;
 layout (location = 3) in vec3 normal;
+#ifdef INSTANCED
+layout (location = 4) in mat4 instanceModel;
+#endif
+
+struct Light
+{
+	vec3 color;
+	vec3 direction;
+};
+
+layout (std140) uniform FrameData
+{
+	mat4 uView;
+	mat4 uProjection;
+	vec3 uCameraPos;
+	int uLightCount;
+	uvec4 uClusterSize;
+	vec4 uClusterDepth;
+	Light uLights[MAX_LIGHTS];
+};
 
 out vec2 vUV;
 out vec3 vNormal;
 out vec3 vFragPos;
 
 uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProjection;
 
 void main()
 {
+#ifdef INSTANCED
+	mat4 model = instanceModel;
+#else
+	mat4 model = uModel;
+#endif
+
 	vUV = uv;
 
-	vFragPos = vec3(uModel * vec4(position, 1.0));
+	vFragPos = vec3(model * vec4(position, 1.0));
 
-	vNormal = mat3(transpose(inverse(uModel))) * normal;
+	vNormal = mat3(transpose(inverse(model))) * normal;
 
-	gl_Position =  uProjection * uView * uModel * vec4(position, 1.0);
+	gl_Position =  uProjection * uView * model * vec4(position, 1.0);
 }
\ No newline at end of file
@@ -1,5 +1,12 @@
 #include "Bullet.h"
 
+void Bullet::OnSpawn()
+{
+	eng::GameObject::OnSpawn();
+	// Bullets come back from the prefab pool
+	m_lifetime = Lifetime;
+}
+
 void Bullet::Update(float deltaTime)
 {
 	eng::GameObject::Update(deltaTime);
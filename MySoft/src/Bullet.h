@@ -5,8 +5,10 @@ class Bullet : public eng::GameObject
 {
 	GAMEOBJECT(Bullet)
 public:
+	void OnSpawn() override;
 	void Update(float deltaTime) override;
 
 private:
-	float m_lifetime = 2.0f;
+	static constexpr float Lifetime = 2.0f;
+	float m_lifetime = Lifetime;
 };
\ No newline at end of file
@@ -43,25 +43,33 @@ void Player::Update(float deltaTime)
 				m_audioComponent->Play("shoot");
 			}
 
-			auto bullet = m_scene->CreateObject<Bullet>("Bullet");
-			auto material = eng::Material::Load("materials/suzanne.mat");
-			auto mesh = eng::Mesh::CreateSphere(0.2f, 32, 32);
-			bullet->AddComponent(new eng::MeshComponent(material, mesh));
+			if (!m_bulletPrefab)
+			{
+				auto material = eng::Engine::GetInstance().GetMaterialManager().GetOrLoadMaterial("materials/suzanne.mat");
+				auto mesh = eng::Mesh::CreateSphere(0.2f, 32, 32);
+				auto collider = std::make_shared<eng::SphereCollider>(0.2f);
+				m_bulletPrefab = eng::Prefab::Create("Bullet", [material, mesh, collider](eng::GameObject& bullet)
+					{
+						bullet.AddComponent(new eng::MeshComponent(material, mesh));
+						auto rigidBody = std::make_shared<eng::RigidBody>(
+							eng::BodyType::Dynamic, collider, 10.0f, 0.1f);
+						bullet.AddComponent(new eng::PhysicsComponent(rigidBody));
+					});
+			}
 
 			glm::vec3 pos = glm::vec3(0.0f);
 			if (auto child = FindChildByName("BOOM_35"))
 			{
 				pos = child->GetWorldPosition();
 			}
-			bullet->SetPosition(pos + m_rotation * glm::vec3(-0.2f, 0.2f,-1.75f));
-
-			auto collider = std::make_shared<eng::SphereCollider>(0.2f);
-			auto rigidBody = std::make_shared<eng::RigidBody>(
-				eng::BodyType::Dynamic, collider, 10.0f, 0.1f);
-			bullet->AddComponent(new eng::PhysicsComponent(rigidBody));
 
-			glm::vec3 front = m_rotation * glm::vec3(0.0f, 0.0f,-1.0f);
-			rigidBody->ApplyImpulse(front * 500.0f);
+			auto bullet = m_scene->Instantiate(m_bulletPrefab, pos + m_rotation * glm::vec3(-0.2f, 0.2f,-1.75f));
+			auto physics = bullet ? bullet->GetComponent<eng::PhysicsComponent>() : nullptr;
+			if (physics && physics->GetRigidBody())
+			{
+				glm::vec3 front = m_rotation * glm::vec3(0.0f, 0.0f,-1.0f);
+				physics->GetRigidBody()->ApplyImpulse(front * 500.0f);
+			}
 		}
 	}
 
@@ -12,4 +12,7 @@ private:
 	eng::AnimationComponent* m_animationComponent = nullptr;
 	eng::AudioComponent* m_audioComponent = nullptr;
 	eng::PlayerControllerComponent* m_playerControllerComponent = nullptr;
+
+	// Bullets share mesh, material and collider, so the render queue can draw them instanced
+	std::shared_ptr<eng::Prefab> m_bulletPrefab;
 };
\ No newline at end of file
@@ -1,14 +1,41 @@
 #include "Game.h"
 #include "eng.h"
+#include <cstdlib>
+#include <cstring>
 
-int main()
+int main(int argc, char** argv)
 {
+	// --headless runs the game without a window, e.g. on CI machines
+	bool headless = false;
+	// --profile <frames> <file> writes a Chrome trace of the first frames
+	int profileFrames = 0;
+	const char* profileOutput = "trace.json";
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--headless") == 0)
+		{
+			headless = true;
+		}
+		else if (std::strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+		{
+			profileFrames = std::atoi(argv[++i]);
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+			{
+				profileOutput = argv[++i];
+			}
+		}
+	}
+
 	Game* game = new Game();
 	eng::Engine& engine = eng::Engine::GetInstance();
 	engine.SetApplication(game);
 
-	if (engine.Init(1280, 720))
+	if (engine.Init(1280, 720, headless))
 	{
+		if (profileFrames > 0)
+		{
+			eng::Profiler::GetInstance().StartCapture(static_cast<uint32_t>(profileFrames), profileOutput);
+		}
 		engine.Run();
 	}
 	